@@ -0,0 +1,207 @@
+#include "city_generator.h"
+#include "geo.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+
+namespace city_generator {
+
+using namespace json;
+
+namespace {
+
+// Город размером примерно 20 на 20 км, остановки стоят в узлах сетки со случайным сдвигом
+const double MIN_LAT = 55.6;
+const double MAX_LAT = 55.8;
+const double MIN_LNG = 37.5;
+const double MAX_LNG = 37.8;
+// Дорога длиннее расстояния по прямой
+const double MIN_DETOUR = 1.1;
+const double MAX_DETOUR = 1.5;
+// Следующая остановка маршрута выбирается среди ячеек сетки не дальше этого числа шагов,
+// поэтому маршруты, как в настоящем городе, соединяют близкие остановки
+const int NEIGHBOR_RADIUS = 2;
+
+void CheckParameters(const CityParameters &parameters) {
+  if (parameters.stop_count < 2) {
+    throw invalid_argument("City must have at least two stops"s);
+  }
+  if (parameters.min_route_length < 2 || parameters.min_route_length > parameters.max_route_length) {
+    throw invalid_argument("Invalid route length range"s);
+  }
+}
+
+size_t GetRandomIndex(mt19937 &generator, size_t size) {
+  return uniform_int_distribution<size_t>(0, size - 1)(generator);
+}
+
+// Случайная остановка, отличная от предыдущей
+size_t GetNextStop(mt19937 &generator, size_t stop_count, size_t previous) {
+  const size_t offset = uniform_int_distribution<size_t>(1, stop_count - 1)(generator);
+  return (previous + offset) % stop_count;
+}
+
+// Остановки расставлены по ячейкам квадратной сетки построчно, последняя строка может быть неполной
+class StopGrid {
+ public:
+  explicit StopGrid(size_t stop_count)
+      : stop_count_(stop_count),
+        column_count_(static_cast<size_t>(ceil(sqrt(static_cast<double>(stop_count))))),
+        row_count_((stop_count + column_count_ - 1) / column_count_) {}
+
+  [[nodiscard]] geo::Coordinates GetCoordinates(mt19937 &generator, size_t stop) const {
+    uniform_real_distribution<double> jitter(0., 1.);
+    const double row = static_cast<double>(stop / column_count_) + jitter(generator);
+    const double column = static_cast<double>(stop % column_count_) + jitter(generator);
+    return {MIN_LAT + (MAX_LAT - MIN_LAT) * row / static_cast<double>(row_count_),
+            MIN_LNG + (MAX_LNG - MIN_LNG) * column / static_cast<double>(column_count_)};
+  }
+
+  // Случайная соседняя по сетке остановка, отличная от текущей
+  [[nodiscard]] size_t GetNeighbor(mt19937 &generator, size_t stop) const {
+    uniform_int_distribution<int> step(-NEIGHBOR_RADIUS, NEIGHBOR_RADIUS);
+    const auto row = static_cast<int>(stop / column_count_);
+    const auto column = static_cast<int>(stop % column_count_);
+    while (true) {
+      const int next_row = row + step(generator);
+      const int next_column = column + step(generator);
+      if (next_row < 0 || next_column < 0 || next_column >= static_cast<int>(column_count_)) {
+        continue;
+      }
+      const size_t next = static_cast<size_t>(next_row) * column_count_ + static_cast<size_t>(next_column);
+      if (next != stop && next < stop_count_) {
+        return next;
+      }
+    }
+  }
+
+ private:
+  size_t stop_count_;
+  size_t column_count_;
+  size_t row_count_;
+};
+
+}
+
+string GetStopName(size_t index) {
+  return "Stop "s + to_string(index);
+}
+
+string GetBusName(size_t index) {
+  return "Bus "s + to_string(index);
+}
+
+Array GenerateBaseRequests(const CityParameters &parameters) {
+  CheckParameters(parameters);
+  mt19937 generator(parameters.seed);
+  uniform_real_distribution<double> detour_distribution(MIN_DETOUR, MAX_DETOUR);
+  uniform_int_distribution<size_t> route_length_distribution(parameters.min_route_length,
+                                                             parameters.max_route_length);
+  bernoulli_distribution roundtrip_distribution(parameters.roundtrip_share);
+
+  const size_t stop_count = parameters.stop_count;
+  const StopGrid grid(stop_count);
+  vector<geo::Coordinates> coordinates(stop_count);
+  for (size_t stop = 0; stop < stop_count; ++stop) {
+    coordinates[stop] = grid.GetCoordinates(generator, stop);
+  }
+  vector<map<size_t, int>> road_distances(stop_count);
+  const auto add_distance = [&](size_t from, size_t to) {
+    if (road_distances[from].count(to) == 0) {
+      const double distance = geo::ComputeDistance(coordinates[from], coordinates[to]);
+      road_distances[from][to] = static_cast<int>(distance * detour_distribution(generator)) + 1;
+    }
+  };
+
+  Array buses;
+  buses.reserve(parameters.bus_count);
+  for (size_t bus = 0; bus < parameters.bus_count; ++bus) {
+    const bool is_roundtrip = roundtrip_distribution(generator);
+    const size_t route_length = route_length_distribution(generator);
+    // У кольцевого маршрута последняя остановка совпадает с первой и добавляется в конце
+    const size_t unique_length = is_roundtrip ? max<size_t>(route_length, 3) - 1 : route_length;
+    vector<size_t> route{GetRandomIndex(generator, stop_count)};
+    while (route.size() < unique_length) {
+      route.push_back(grid.GetNeighbor(generator, route.back()));
+    }
+    if (is_roundtrip) {
+      if (route.back() == route.front()) {
+        route.push_back(grid.GetNeighbor(generator, route.back()));
+      }
+      route.push_back(route.front());
+    }
+    Array stops;
+    stops.reserve(route.size());
+    for (size_t i = 0; i < route.size(); ++i) {
+      stops.emplace_back(GetStopName(route[i]));
+      if (i > 0) {
+        add_distance(route[i - 1], route[i]);
+      }
+    }
+    buses.emplace_back(Dict{{"type"s, "Bus"s},
+                            {"name"s, GetBusName(bus)},
+                            {"stops"s, std::move(stops)},
+                            {"is_roundtrip"s, is_roundtrip}});
+  }
+
+  const auto extra_distance_count = static_cast<size_t>(parameters.distance_density * static_cast<double>(stop_count));
+  for (size_t i = 0; i < extra_distance_count; ++i) {
+    const size_t from = GetRandomIndex(generator, stop_count);
+    add_distance(from, grid.GetNeighbor(generator, from));
+  }
+
+  Array requests;
+  requests.reserve(stop_count + buses.size());
+  for (size_t stop = 0; stop < stop_count; ++stop) {
+    Dict distances;
+    for (const auto &[to, distance] : road_distances[stop]) {
+      distances.emplace(GetStopName(to), distance);
+    }
+    requests.emplace_back(Dict{{"type"s, "Stop"s},
+                               {"name"s, GetStopName(stop)},
+                               {"latitude"s, coordinates[stop].lat},
+                               {"longitude"s, coordinates[stop].lng},
+                               {"road_distances"s, std::move(distances)}});
+  }
+  for (auto &bus : buses) {
+    requests.push_back(std::move(bus));
+  }
+  return requests;
+}
+
+Array GenerateStatRequests(const CityParameters &parameters, size_t request_count) {
+  CheckParameters(parameters);
+  // Отдельная последовательность, чтобы запросы не зависели от числа запросов к генератору сети
+  mt19937 generator(parameters.seed + 1);
+  Array requests;
+  requests.reserve(request_count);
+  for (size_t i = 0; i < request_count; ++i) {
+    const int id = static_cast<int>(i) + 1;
+    if (i % 100 == 99) {
+      requests.emplace_back(Dict{{"id"s, id}, {"type"s, "Map"s}});
+    } else if (i % 3 == 0 && parameters.bus_count > 0) {
+      requests.emplace_back(Dict{{"id"s, id},
+                                 {"type"s, "Bus"s},
+                                 {"name"s, GetBusName(GetRandomIndex(generator, parameters.bus_count))}});
+    } else if (i % 3 == 1) {
+      requests.emplace_back(Dict{{"id"s, id},
+                                 {"type"s, "Stop"s},
+                                 {"name"s, GetStopName(GetRandomIndex(generator, parameters.stop_count))}});
+    } else {
+      const size_t from = GetRandomIndex(generator, parameters.stop_count);
+      requests.emplace_back(Dict{{"id"s, id},
+                                 {"type"s, "Route"s},
+                                 {"from"s, GetStopName(from)},
+                                 {"to"s, GetStopName(GetNextStop(generator, parameters.stop_count, from))}});
+    }
+  }
+  return requests;
+}
+
+}
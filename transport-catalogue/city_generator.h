@@ -0,0 +1,34 @@
+#pragma once
+
+#include "json.h"
+
+#include <cstdint>
+
+namespace city_generator {
+
+// Параметры синтетической транспортной сети. При одинаковых параметрах сеть одна и та же
+struct CityParameters {
+  size_t stop_count = 1000;
+  size_t bus_count = 100;
+  // Число остановок в описании маршрута
+  size_t min_route_length = 5;
+  size_t max_route_length = 30;
+  // Сколько дополнительных расстояний между случайными парами остановок приходится на одну остановку.
+  // Расстояния между соседними остановками маршрутов задаются всегда
+  double distance_density = 0.5;
+  // Доля кольцевых маршрутов
+  double roundtrip_share = 0.5;
+  uint32_t seed = 42;
+};
+
+// Запросы base_requests: сначала остановки, затем автобусы
+json::Array GenerateBaseRequests(const CityParameters &parameters);
+
+// Запросы stat_requests: Bus, Stop и Route по кругу, Map - один на сто запросов
+json::Array GenerateStatRequests(const CityParameters &parameters, size_t request_count);
+
+std::string GetStopName(size_t index);
+
+std::string GetBusName(size_t index);
+
+}
@@ -0,0 +1,485 @@
+#pragma once
+
+#include "graph.h"
+#include "router.h"
+
+#include <algorithm>
+#include <functional>
+#include <optional>
+#include <queue>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+// Ребро-сокращение: заменяет путь из двух рёбер иерархии first и second.
+// Рёбра иерархии с номерами меньше числа рёбер исходного графа совпадают с ними,
+// сокращение с индексом i в списке имеет номер GetEdgeCount() + i
+template<typename Weight>
+struct Shortcut {
+  VertexId from;
+  VertexId to;
+  Weight weight;
+  EdgeId first;
+  EdgeId second;
+};
+
+template<typename Weight>
+struct ContractionHierarchy {
+  std::vector<size_t> ranks;
+  std::vector<Shortcut<Weight>> shortcuts;
+};
+
+// Проверяет, что иерархия, например прочитанная из файла, подходит к графу: ранги вершин - перестановка
+// чисел от 0 до V - 1, а сокращение заменяет два смежных ребра с меньшими номерами, чем у него самого,
+// с тем же началом, концом и суммарным весом, поэтому раскрытие сокращений конечно и даёт верный путь
+template<typename Weight, typename Graph>
+bool IsValidContractionHierarchy(const ContractionHierarchy<Weight> &hierarchy, const Graph &graph) {
+  const size_t vertex_count = graph.GetVertexCount();
+  const size_t edge_count = graph.GetEdgeCount();
+  if (hierarchy.ranks.size() != vertex_count) {
+    return false;
+  }
+  std::vector<bool> is_rank_used(vertex_count);
+  for (const size_t rank : hierarchy.ranks) {
+    if (rank >= vertex_count || is_rank_used[rank]) {
+      return false;
+    }
+    is_rank_used[rank] = true;
+  }
+  const auto get_edge = [&](EdgeId edge_id) -> Edge<Weight> {
+    if (edge_id < edge_count) {
+      return graph.GetEdge(edge_id);
+    }
+    const auto &shortcut = hierarchy.shortcuts[edge_id - edge_count];
+    return {shortcut.from, shortcut.to, shortcut.weight};
+  };
+  for (size_t i = 0; i < hierarchy.shortcuts.size(); ++i) {
+    const auto &shortcut = hierarchy.shortcuts[i];
+    const size_t shortcut_id = edge_count + i;
+    if (shortcut.from >= vertex_count || shortcut.to >= vertex_count
+        || shortcut.first >= shortcut_id || shortcut.second >= shortcut_id) {
+      return false;
+    }
+    const auto first = get_edge(shortcut.first);
+    const auto second = get_edge(shortcut.second);
+    if (first.from != shortcut.from || first.to != second.from || second.to != shortcut.to
+        || first.weight + second.weight != shortcut.weight) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Строит иерархию сжатия: вершины по очереди удаляются из графа в порядке,
+// выбираемом по разности рёбер, а кратчайшие пути через удалённую вершину
+// сохраняются сокращениями
+template<typename Weight, typename Graph = DirectedWeightedGraph<Weight>>
+class ContractionHierarchyBuilder {
+ private:
+  using Neighbours = std::unordered_map<VertexId, EdgeId>;
+
+ public:
+  explicit ContractionHierarchyBuilder(const Graph &graph);
+
+  ContractionHierarchy<Weight> Build();
+
+ private:
+  using QueueItem = std::pair<int, VertexId>;
+  using Queue = std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<>>;
+  using WitnessQueueItem = std::pair<Weight, VertexId>;
+  using WitnessQueue =
+      std::priority_queue<WitnessQueueItem, std::vector<WitnessQueueItem>, std::greater<>>;
+
+  // Ограничение поиска свидетеля: если путь не найден за это число шагов,
+  // сокращение добавляется без доказательства его необходимости
+  static constexpr size_t WITNESS_SETTLE_LIMIT = 500;
+  static constexpr Weight ZERO_WEIGHT{};
+
+  const Graph &graph_;
+  ContractionHierarchy<Weight> hierarchy_;
+  std::vector<Neighbours> out_edges_;
+  std::vector<Neighbours> in_edges_;
+  std::vector<bool> contracted_;
+  std::vector<int> contracted_neighbours_;
+
+  [[nodiscard]] Weight GetWeight(EdgeId edge_id) const {
+    return edge_id < graph_.GetEdgeCount()
+           ? graph_.GetEdge(edge_id).weight
+           : hierarchy_.shortcuts[edge_id - graph_.GetEdgeCount()].weight;
+  }
+
+  void AddEdge(VertexId from, VertexId to, EdgeId edge_id) {
+    const auto it = out_edges_[from].find(to);
+    if (it == out_edges_[from].end() || GetWeight(edge_id) < GetWeight(it->second)) {
+      out_edges_[from][to] = edge_id;
+      in_edges_[to][from] = edge_id;
+    }
+  }
+
+  [[nodiscard]] std::vector<Shortcut<Weight>> FindShortcuts(VertexId vertex) const;
+
+  [[nodiscard]] std::unordered_map<VertexId, Weight> FindWitnesses(VertexId from,
+                                                                   VertexId excluded,
+                                                                   Weight max_weight) const;
+
+  [[nodiscard]] int GetPriority(VertexId vertex) const;
+
+  void Contract(VertexId vertex, size_t rank);
+};
+
+template<typename Weight, typename Graph>
+ContractionHierarchyBuilder<Weight, Graph>::ContractionHierarchyBuilder(const Graph &graph)
+    : graph_(graph),
+      out_edges_(graph.GetVertexCount()),
+      in_edges_(graph.GetVertexCount()),
+      contracted_(graph.GetVertexCount(), false),
+      contracted_neighbours_(graph.GetVertexCount(), 0) {
+  hierarchy_.ranks.resize(graph.GetVertexCount());
+  for (EdgeId edge_id = 0; edge_id < graph.GetEdgeCount(); ++edge_id) {
+    const auto &edge = graph.GetEdge(edge_id);
+    if (edge.weight < ZERO_WEIGHT) {
+      throw std::domain_error("Edges' weights should be non-negative");
+    }
+    // Петли никогда не входят в кратчайшие пути
+    if (edge.from != edge.to) {
+      AddEdge(edge.from, edge.to, edge_id);
+    }
+  }
+}
+
+template<typename Weight, typename Graph>
+ContractionHierarchy<Weight> ContractionHierarchyBuilder<Weight, Graph>::Build() {
+  Queue queue;
+  for (VertexId vertex = 0; vertex < graph_.GetVertexCount(); ++vertex) {
+    queue.emplace(GetPriority(vertex), vertex);
+  }
+  size_t rank = 0;
+  while (!queue.empty()) {
+    const VertexId vertex = queue.top().second;
+    queue.pop();
+    // Приоритеты пересчитываются лениво: если вершина подешевела не так, как соседи,
+    // она возвращается в очередь
+    const int priority = GetPriority(vertex);
+    if (!queue.empty() && priority > queue.top().first) {
+      queue.emplace(priority, vertex);
+      continue;
+    }
+    Contract(vertex, rank++);
+  }
+  return std::move(hierarchy_);
+}
+
+template<typename Weight, typename Graph>
+std::unordered_map<VertexId, Weight>
+ContractionHierarchyBuilder<Weight, Graph>::FindWitnesses(VertexId from,
+                                                          VertexId excluded,
+                                                          Weight max_weight) const {
+  std::unordered_map<VertexId, Weight> weights{{from, ZERO_WEIGHT}};
+  WitnessQueue queue;
+  queue.emplace(ZERO_WEIGHT, from);
+  for (size_t settled = 0; !queue.empty() && settled < WITNESS_SETTLE_LIMIT; ++settled) {
+    const auto [weight, vertex] = queue.top();
+    queue.pop();
+    if (weights.at(vertex) < weight) {
+      continue;
+    }
+    if (max_weight < weight) {
+      break;
+    }
+    for (const auto &[to, edge_id] : out_edges_[vertex]) {
+      if (to == excluded || contracted_[to]) {
+        continue;
+      }
+      const Weight candidate_weight = weight + GetWeight(edge_id);
+      const auto it = weights.find(to);
+      if (it == weights.end() || candidate_weight < it->second) {
+        weights[to] = candidate_weight;
+        queue.emplace(candidate_weight, to);
+      }
+    }
+  }
+  return weights;
+}
+
+template<typename Weight, typename Graph>
+std::vector<Shortcut<Weight>> ContractionHierarchyBuilder<Weight, Graph>::FindShortcuts(VertexId vertex) const {
+  std::vector<Shortcut<Weight>> shortcuts;
+  for (const auto &[from, in_edge_id] : in_edges_[vertex]) {
+    if (contracted_[from]) {
+      continue;
+    }
+    const Weight in_weight = GetWeight(in_edge_id);
+    Weight max_weight = in_weight;
+    for (const auto &[to, out_edge_id] : out_edges_[vertex]) {
+      if (!contracted_[to] && to != from) {
+        max_weight = std::max(max_weight, in_weight + GetWeight(out_edge_id));
+      }
+    }
+    const auto witnesses = FindWitnesses(from, vertex, max_weight);
+    for (const auto &[to, out_edge_id] : out_edges_[vertex]) {
+      if (contracted_[to] || to == from) {
+        continue;
+      }
+      const Weight weight = in_weight + GetWeight(out_edge_id);
+      const auto it = witnesses.find(to);
+      if (it == witnesses.end() || weight < it->second) {
+        shortcuts.push_back({from, to, weight, in_edge_id, out_edge_id});
+      }
+    }
+  }
+  return shortcuts;
+}
+
+template<typename Weight, typename Graph>
+int ContractionHierarchyBuilder<Weight, Graph>::GetPriority(VertexId vertex) const {
+  int removed_edges = 0;
+  for (const auto &[from, _] : in_edges_[vertex]) {
+    removed_edges += contracted_[from] ? 0 : 1;
+  }
+  for (const auto &[to, _] : out_edges_[vertex]) {
+    removed_edges += contracted_[to] ? 0 : 1;
+  }
+  const int added_edges = static_cast<int>(FindShortcuts(vertex).size());
+  return added_edges - removed_edges + contracted_neighbours_[vertex];
+}
+
+template<typename Weight, typename Graph>
+void ContractionHierarchyBuilder<Weight, Graph>::Contract(VertexId vertex, size_t rank) {
+  for (auto &shortcut : FindShortcuts(vertex)) {
+    const EdgeId edge_id = graph_.GetEdgeCount() + hierarchy_.shortcuts.size();
+    hierarchy_.shortcuts.push_back(shortcut);
+    AddEdge(shortcut.from, shortcut.to, edge_id);
+  }
+  contracted_[vertex] = true;
+  hierarchy_.ranks[vertex] = rank;
+  for (const auto &[from, _] : in_edges_[vertex]) {
+    ++contracted_neighbours_[from];
+  }
+  for (const auto &[to, _] : out_edges_[vertex]) {
+    ++contracted_neighbours_[to];
+  }
+}
+
+template<typename Weight, typename Graph>
+ContractionHierarchy<Weight> BuildContractionHierarchy(const Graph &graph) {
+  return ContractionHierarchyBuilder<Weight, Graph>(graph).Build();
+}
+
+// Отвечает на запросы двунаправленным поиском Дейкстры, который из каждой вершины
+// идёт только к вершинам с большим рангом, а затем раскрывает сокращения
+// обратно в рёбра исходного графа
+template<typename Weight, typename Graph = DirectedWeightedGraph<Weight>>
+class ContractionHierarchyRouter {
+ public:
+  explicit ContractionHierarchyRouter(const Graph &graph);
+
+  ContractionHierarchyRouter(const Graph &graph, ContractionHierarchy<Weight> hierarchy);
+
+  using RouteInfo = graph::RouteInfo<Weight>;
+
+  std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const;
+
+  [[nodiscard]] const ContractionHierarchy<Weight> &GetContractionHierarchy() const;
+
+ private:
+  struct Label {
+    Weight weight;
+    std::optional<EdgeId> prev_edge;
+  };
+  using Labels = std::unordered_map<VertexId, Label>;
+  using QueueItem = std::pair<Weight, VertexId>;
+  using Queue = std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<>>;
+
+  static constexpr Weight ZERO_WEIGHT{};
+  const Graph &graph_;
+  ContractionHierarchy<Weight> hierarchy_;
+  // Рёбра иерархии, ведущие из вершины вверх, и рёбра, ведущие в неё сверху
+  std::vector<std::vector<EdgeId>> upward_edges_;
+  std::vector<std::vector<EdgeId>> downward_edges_;
+
+  [[nodiscard]] Edge<Weight> GetHierarchyEdge(EdgeId edge_id) const {
+    if (edge_id < graph_.GetEdgeCount()) {
+      return graph_.GetEdge(edge_id);
+    }
+    const auto &shortcut = hierarchy_.shortcuts.at(edge_id - graph_.GetEdgeCount());
+    return {shortcut.from, shortcut.to, shortcut.weight};
+  }
+
+  void BuildSearchGraph();
+
+  void UnpackEdge(EdgeId edge_id, std::vector<EdgeId> &edges) const;
+};
+
+template<typename Weight>
+ContractionHierarchyRouter(const DirectedWeightedGraph<Weight> &) -> ContractionHierarchyRouter<Weight>;
+
+template<typename Weight>
+ContractionHierarchyRouter(const CsrGraph<Weight> &)
+-> ContractionHierarchyRouter<Weight, CsrGraph<Weight>>;
+
+template<typename Weight>
+ContractionHierarchyRouter(const DirectedWeightedGraph<Weight> &, ContractionHierarchy<Weight>)
+-> ContractionHierarchyRouter<Weight>;
+
+template<typename Weight>
+ContractionHierarchyRouter(const CsrGraph<Weight> &, ContractionHierarchy<Weight>)
+-> ContractionHierarchyRouter<Weight, CsrGraph<Weight>>;
+
+template<typename Weight, typename Graph>
+ContractionHierarchyRouter<Weight, Graph>::ContractionHierarchyRouter(const Graph &graph)
+    : ContractionHierarchyRouter(graph, BuildContractionHierarchy<Weight>(graph)) {
+}
+
+template<typename Weight, typename Graph>
+ContractionHierarchyRouter<Weight, Graph>::ContractionHierarchyRouter(const Graph &graph,
+                                                               ContractionHierarchy<Weight> hierarchy)
+    : graph_(graph),
+      hierarchy_(std::move(hierarchy)),
+      upward_edges_(graph.GetVertexCount()),
+      downward_edges_(graph.GetVertexCount()) {
+  if (!IsValidContractionHierarchy(hierarchy_, graph)) {
+    throw std::invalid_argument("Contraction hierarchy does not match the graph");
+  }
+  BuildSearchGraph();
+}
+
+template<typename Weight, typename Graph>
+void ContractionHierarchyRouter<Weight, Graph>::BuildSearchGraph() {
+  // Из параллельных рёбер иерархии в поиске участвует только самое лёгкое
+  std::vector<std::unordered_map<VertexId, EdgeId>> upward(graph_.GetVertexCount());
+  std::vector<std::unordered_map<VertexId, EdgeId>> downward(graph_.GetVertexCount());
+  const auto add_edge = [this](auto &edges, VertexId vertex, VertexId neighbour, EdgeId edge_id) {
+    const auto it = edges[vertex].find(neighbour);
+    if (it == edges[vertex].end()
+        || GetHierarchyEdge(edge_id).weight < GetHierarchyEdge(it->second).weight) {
+      edges[vertex][neighbour] = edge_id;
+    }
+  };
+  const size_t edge_count = graph_.GetEdgeCount() + hierarchy_.shortcuts.size();
+  for (EdgeId edge_id = 0; edge_id < edge_count; ++edge_id) {
+    const auto edge = GetHierarchyEdge(edge_id);
+    if (hierarchy_.ranks[edge.from] < hierarchy_.ranks[edge.to]) {
+      add_edge(upward, edge.from, edge.to, edge_id);
+    } else if (hierarchy_.ranks[edge.to] < hierarchy_.ranks[edge.from]) {
+      add_edge(downward, edge.to, edge.from, edge_id);
+    }
+  }
+  for (VertexId vertex = 0; vertex < graph_.GetVertexCount(); ++vertex) {
+    for (const auto &[_, edge_id] : upward[vertex]) {
+      upward_edges_[vertex].push_back(edge_id);
+    }
+    for (const auto &[_, edge_id] : downward[vertex]) {
+      downward_edges_[vertex].push_back(edge_id);
+    }
+    // Порядок обхода не должен зависеть от устройства хеш-таблиц
+    std::sort(upward_edges_[vertex].begin(), upward_edges_[vertex].end());
+    std::sort(downward_edges_[vertex].begin(), downward_edges_[vertex].end());
+  }
+}
+
+template<typename Weight, typename Graph>
+void ContractionHierarchyRouter<Weight, Graph>::UnpackEdge(EdgeId edge_id, std::vector<EdgeId> &edges) const {
+  std::vector<EdgeId> stack{edge_id};
+  while (!stack.empty()) {
+    const EdgeId current = stack.back();
+    stack.pop_back();
+    if (current < graph_.GetEdgeCount()) {
+      edges.push_back(current);
+    } else {
+      const auto &shortcut = hierarchy_.shortcuts[current - graph_.GetEdgeCount()];
+      stack.push_back(shortcut.second);
+      stack.push_back(shortcut.first);
+    }
+  }
+}
+
+template<typename Weight, typename Graph>
+std::optional<typename ContractionHierarchyRouter<Weight, Graph>::RouteInfo>
+ContractionHierarchyRouter<Weight, Graph>::BuildRoute(VertexId from, VertexId to) const {
+  if (from >= graph_.GetVertexCount() || to >= graph_.GetVertexCount()) {
+    throw std::out_of_range("Vertex is out of range");
+  }
+
+  Labels forward_labels{{from, {ZERO_WEIGHT, std::nullopt}}};
+  Labels backward_labels{{to, {ZERO_WEIGHT, std::nullopt}}};
+  Queue forward_queue;
+  Queue backward_queue;
+  forward_queue.emplace(ZERO_WEIGHT, from);
+  backward_queue.emplace(ZERO_WEIGHT, to);
+  std::optional<Weight> best_weight;
+  VertexId meeting_vertex = from;
+
+  while (!forward_queue.empty() || !backward_queue.empty()) {
+    const bool is_forward = backward_queue.empty()
+        || (!forward_queue.empty() && !(backward_queue.top().first < forward_queue.top().first));
+    auto &queue = is_forward ? forward_queue : backward_queue;
+    auto &labels = is_forward ? forward_labels : backward_labels;
+    const auto &opposite_labels = is_forward ? backward_labels : forward_labels;
+
+    const auto [weight, vertex] = queue.top();
+    queue.pop();
+    if (best_weight && !(weight < *best_weight)) {
+      // Дальнейший поиск в этом направлении не может улучшить ответ
+      queue = Queue();
+      continue;
+    }
+    if (labels.at(vertex).weight < weight) {
+      continue;
+    }
+    if (const auto it = opposite_labels.find(vertex); it != opposite_labels.end()) {
+      const Weight candidate_weight = weight + it->second.weight;
+      if (!best_weight || candidate_weight < *best_weight) {
+        best_weight = candidate_weight;
+        meeting_vertex = vertex;
+      }
+    }
+    for (const EdgeId edge_id : (is_forward ? upward_edges_ : downward_edges_)[vertex]) {
+      const auto edge = GetHierarchyEdge(edge_id);
+      const VertexId next = is_forward ? edge.to : edge.from;
+      const Weight candidate_weight = weight + edge.weight;
+      const auto it = labels.find(next);
+      if (it == labels.end() || candidate_weight < it->second.weight) {
+        labels[next] = {candidate_weight, edge_id};
+        queue.emplace(candidate_weight, next);
+      }
+    }
+  }
+
+  if (!best_weight) {
+    return std::nullopt;
+  }
+
+  std::vector<EdgeId> hierarchy_edges;
+  for (auto edge_id = forward_labels.at(meeting_vertex).prev_edge;
+       edge_id;
+       edge_id = forward_labels.at(GetHierarchyEdge(*edge_id).from).prev_edge) {
+    hierarchy_edges.push_back(*edge_id);
+  }
+  std::reverse(hierarchy_edges.begin(), hierarchy_edges.end());
+  for (auto edge_id = backward_labels.at(meeting_vertex).prev_edge;
+       edge_id;
+       edge_id = backward_labels.at(GetHierarchyEdge(*edge_id).to).prev_edge) {
+    hierarchy_edges.push_back(*edge_id);
+  }
+
+  std::vector<EdgeId> edges;
+  for (const EdgeId edge_id : hierarchy_edges) {
+    UnpackEdge(edge_id, edges);
+  }
+  // Вес пересчитывается вдоль пути в том же порядке, что и у DijkstraRouter
+  Weight weight = ZERO_WEIGHT;
+  for (const EdgeId edge_id : edges) {
+    weight = weight + graph_.GetEdge(edge_id).weight;
+  }
+  return RouteInfo{weight, std::move(edges)};
+}
+
+template<typename Weight, typename Graph>
+const ContractionHierarchy<Weight> &ContractionHierarchyRouter<Weight, Graph>::GetContractionHierarchy() const {
+  return hierarchy_;
+}
+
+}  // namespace graph
@@ -0,0 +1,150 @@
+#pragma once
+
+#include "graph.h"
+#include "router.h"
+
+#include <algorithm>
+#include <functional>
+#include <optional>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+// Ищет кратчайший путь алгоритмом Дейкстры на двоичной куче при каждом запросе.
+// В отличие от Router не хранит таблицу V×V, поэтому создаётся мгновенно,
+// а память растёт линейно от числа рёбер
+template<typename Weight, typename Graph = DirectedWeightedGraph<Weight>>
+class DijkstraRouter {
+ public:
+  explicit DijkstraRouter(const Graph &graph);
+
+  using RouteInfo = graph::RouteInfo<Weight>;
+
+  // Кратчайшие пути из одной вершины: вес и последнее ребро пути до каждой вершины,
+  // nullopt - вершина недостижима
+  struct ShortestPathTree {
+    std::vector<std::optional<Weight>> weights;
+    std::vector<std::optional<EdgeId>> prev_edges;
+  };
+
+  std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const;
+
+  // Один поиск без остановки у цели, пути до любых вершин затем восстанавливаются по дереву.
+  // С max_weight поиск не продолжается за вершины дальше max_weight, и они остаются недостижимыми
+  ShortestPathTree BuildShortestPathTree(VertexId from, std::optional<Weight> max_weight = std::nullopt) const;
+
+  std::optional<RouteInfo> GetRoute(const ShortestPathTree &tree, VertexId to) const;
+
+ private:
+  using QueueItem = std::pair<Weight, VertexId>;
+  using Queue = std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<>>;
+
+  static constexpr Weight ZERO_WEIGHT{};
+  const Graph &graph_;
+
+  ShortestPathTree Search(VertexId from,
+                          std::optional<VertexId> to,
+                          std::optional<Weight> max_weight = std::nullopt) const;
+};
+
+template<typename Weight>
+DijkstraRouter(const DirectedWeightedGraph<Weight> &) -> DijkstraRouter<Weight>;
+
+template<typename Weight>
+DijkstraRouter(const CsrGraph<Weight> &) -> DijkstraRouter<Weight, CsrGraph<Weight>>;
+
+template<typename Weight, typename Graph>
+DijkstraRouter<Weight, Graph>::DijkstraRouter(const Graph &graph) : graph_(graph) {
+  for (EdgeId edge_id = 0; edge_id < graph.GetEdgeCount(); ++edge_id) {
+    if (graph.GetEdge(edge_id).weight < ZERO_WEIGHT) {
+      throw std::domain_error("Edges' weights should be non-negative");
+    }
+  }
+}
+
+template<typename Weight, typename Graph>
+std::optional<typename DijkstraRouter<Weight, Graph>::RouteInfo>
+DijkstraRouter<Weight, Graph>::BuildRoute(VertexId from, VertexId to) const {
+  if (to >= graph_.GetVertexCount()) {
+    throw std::out_of_range("Vertex is out of range");
+  }
+  return GetRoute(Search(from, to), to);
+}
+
+template<typename Weight, typename Graph>
+typename DijkstraRouter<Weight, Graph>::ShortestPathTree
+DijkstraRouter<Weight, Graph>::BuildShortestPathTree(VertexId from, std::optional<Weight> max_weight) const {
+  return Search(from, std::nullopt, max_weight);
+}
+
+template<typename Weight, typename Graph>
+std::optional<typename DijkstraRouter<Weight, Graph>::RouteInfo>
+DijkstraRouter<Weight, Graph>::GetRoute(const ShortestPathTree &tree, VertexId to) const {
+  if (to >= tree.weights.size()) {
+    throw std::out_of_range("Vertex is out of range");
+  }
+  if (!tree.weights[to]) {
+    return std::nullopt;
+  }
+  std::vector<EdgeId> edges;
+  for (std::optional<EdgeId> edge_id = tree.prev_edges[to];
+       edge_id;
+       edge_id = tree.prev_edges[graph_.GetEdge(*edge_id).from]) {
+    edges.push_back(*edge_id);
+  }
+  std::reverse(edges.begin(), edges.end());
+
+  return RouteInfo{*tree.weights[to], std::move(edges)};
+}
+
+// Поиск останавливается, когда из очереди извлечена вершина to, без to строится всё дерево
+template<typename Weight, typename Graph>
+typename DijkstraRouter<Weight, Graph>::ShortestPathTree
+DijkstraRouter<Weight, Graph>::Search(VertexId from,
+                                      std::optional<VertexId> to,
+                                      std::optional<Weight> max_weight) const {
+  const size_t vertex_count = graph_.GetVertexCount();
+  if (from >= vertex_count) {
+    throw std::out_of_range("Vertex is out of range");
+  }
+
+  ShortestPathTree tree{std::vector<std::optional<Weight>>(vertex_count),
+                        std::vector<std::optional<EdgeId>>(vertex_count)};
+  auto &weights = tree.weights;
+  auto &prev_edges = tree.prev_edges;
+  Queue queue;
+  weights[from] = ZERO_WEIGHT;
+  queue.emplace(ZERO_WEIGHT, from);
+
+  while (!queue.empty()) {
+    const auto [weight, vertex] = queue.top();
+    queue.pop();
+    if (vertex == to) {
+      break;
+    }
+    // В очереди могли остаться устаревшие записи об уже улучшенных вершинах
+    if (*weights[vertex] < weight) {
+      continue;
+    }
+    for (const auto &incident_edge : graph_.GetIncidentEdges(vertex)) {
+      const auto edge = GetIncidentEdge<Weight>(graph_, incident_edge);
+      const Weight candidate_weight = weight + edge.weight;
+      if (max_weight && *max_weight < candidate_weight) {
+        continue;
+      }
+      auto &target_weight = weights[edge.to];
+      if (!target_weight || candidate_weight < *target_weight) {
+        target_weight = candidate_weight;
+        prev_edges[edge.to] = edge.id;
+        queue.emplace(candidate_weight, edge.to);
+      }
+    }
+  }
+
+  return tree;
+}
+
+}  // namespace graph
@@ -0,0 +1,68 @@
+#include "distance_matrix.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+namespace transport_catalogue::detail {
+
+DistanceMatrix::DistanceMatrix(size_t stop_count, const vector<Distance> &distances) {
+  // Заданные расстояния идут раньше обратных с тем же ключом и вытесняют их
+  struct Item {
+    StopId from;
+    StopId to;
+    bool is_reversed;
+    int distance;
+  };
+  vector<Item> items;
+  items.reserve(distances.size() * 2);
+  for (const auto &[from, to, distance] : distances) {
+    if (from >= stop_count || to >= stop_count) {
+      throw out_of_range("Stop id is out of range");
+    }
+    items.push_back({from, to, false, distance});
+    items.push_back({to, from, true, distance});
+  }
+  sort(items.begin(), items.end(), [](const Item &lhs, const Item &rhs) {
+    return tie(lhs.from, lhs.to, lhs.is_reversed) < tie(rhs.from, rhs.to, rhs.is_reversed);
+  });
+  items.erase(unique(items.begin(), items.end(), [](const Item &lhs, const Item &rhs) {
+    return lhs.from == rhs.from && lhs.to == rhs.to;
+  }), items.end());
+
+  offsets_.assign(stop_count + 1, 0);
+  neighbours_.reserve(items.size());
+  distances_.reserve(items.size());
+  for (const auto &item : items) {
+    ++offsets_[item.from + 1];
+    neighbours_.push_back(item.to);
+    distances_.push_back(item.distance);
+  }
+  for (size_t i = 0; i < stop_count; ++i) {
+    offsets_[i + 1] += offsets_[i];
+  }
+}
+
+optional<int> DistanceMatrix::GetDistance(StopId stop_from, StopId stop_to) const {
+  if (stop_from >= GetStopCount()) {
+    return nullopt;
+  }
+  const auto begin = neighbours_.begin() + offsets_[stop_from];
+  const auto end = neighbours_.begin() + offsets_[stop_from + 1];
+  const auto it = lower_bound(begin, end, stop_to);
+  if (it == end || *it != stop_to) {
+    return nullopt;
+  }
+  return distances_[it - neighbours_.begin()];
+}
+
+size_t DistanceMatrix::GetStopCount() const {
+  return offsets_.size() - 1;
+}
+
+size_t DistanceMatrix::GetDistanceCount() const {
+  return neighbours_.size();
+}
+
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "domain.h"
+
+#include <cstdint>
+#include <optional>
+#include <tuple>
+#include <vector>
+
+namespace transport_catalogue::detail {
+
+// Расстояния между остановками в формате CSR: для каждой остановки отсортированный
+// по StopId массив соседей. Если расстояние задано только в обратную сторону,
+// оно заранее записывается и в прямую, поэтому поиск - один бинарный поиск в строке
+class DistanceMatrix {
+ public:
+  using Distance = std::tuple<StopId, StopId, int>;
+
+  DistanceMatrix() = default;
+
+  DistanceMatrix(size_t stop_count, const std::vector<Distance> &distances);
+
+  [[nodiscard]] std::optional<int> GetDistance(StopId stop_from, StopId stop_to) const;
+
+  [[nodiscard]] size_t GetStopCount() const;
+
+  [[nodiscard]] size_t GetDistanceCount() const;
+
+ private:
+  std::vector<std::uint32_t> offsets_{0};
+  std::vector<StopId> neighbours_;
+  std::vector<int> distances_;
+};
+
+}
@@ -7,6 +7,7 @@
 #include <set>
 #include <unordered_map>
 #include <algorithm>
+#include <cstdint>
 //#include <execution>
 
 using namespace std::string_literals;
@@ -20,10 +21,15 @@ struct PairHash {
   }
 };
 
+// Плотные номера остановок и автобусов в порядке добавления в справочник
+using StopId = std::uint32_t;
+using BusId = std::uint32_t;
+
 struct Stop {
   std::string name;
   geo::Coordinates coordinates;
   std::set<std::string_view> buses_through_stop;
+  StopId id = 0;
 };
 
 enum class RouteType { CIRCULAR, LINEAR };
@@ -36,6 +42,9 @@ struct Bus {
   double geo_route_distance = 0.;
   int route_distance = 0;
   double curvature = 0.;
+  BusId id = 0;
+  // Те же остановки маршрута, что и в stops_on_route. Если не задан, заполняется справочником
+  std::vector<StopId> stop_ids_on_route;
   [[nodiscard]] size_t GetStopCount() const;
 };
 
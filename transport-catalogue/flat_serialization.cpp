@@ -0,0 +1,608 @@
+#include "flat_serialization.h"
+#include "serialization.h"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define TC_HAS_MMAP
+#endif
+
+using namespace std;
+
+namespace serialization {
+
+using namespace transport_catalogue;
+using namespace detail;
+using namespace renderer;
+using namespace routing;
+
+namespace {
+
+constexpr array<char, 8> FLAT_MAGIC{'T', 'C', 'F', 'L', 'A', 'T', '\0', '\0'};
+constexpr uint32_t FLAT_VERSION = 4;
+constexpr uint32_t NO_STOP = numeric_limits<uint32_t>::max();
+constexpr uint64_t NO_EDGE = numeric_limits<uint64_t>::max();
+constexpr size_t SECTION_ALIGNMENT = 8;
+
+enum class FlatSection : uint32_t {
+  STRINGS,
+  STOPS,
+  BUSES,
+  ROUTE_STOPS,
+  DISTANCES,
+  RENDER_SETTINGS,
+  ROUTING_SETTINGS,
+  GRAPH_EDGES,
+  GRAPH_OFFSETS,
+  GRAPH_INCIDENT_EDGES,
+  ROUTER_EDGES,
+  ROUTER_VERTEXES,
+  HIERARCHY_RANKS,
+  HIERARCHY_SHORTCUTS,
+  ALL_PAIRS_ROUTES,
+  RENDERED_MAP,
+  COUNT
+};
+
+constexpr size_t SECTION_COUNT = static_cast<size_t>(FlatSection::COUNT);
+
+struct FlatHeader {
+  array<char, 8> magic;
+  uint32_t version;
+  uint32_t section_count;
+};
+
+struct FlatSectionEntry {
+  uint64_t offset;
+  uint64_t size;
+};
+
+struct FlatString {
+  uint64_t offset;
+  uint64_t size;
+};
+
+struct FlatStop {
+  FlatString name;
+  double lat;
+  double lng;
+};
+
+struct FlatBus {
+  FlatString name;
+  uint64_t route_offset;
+  uint64_t route_size;
+  uint64_t unique_stops_count;
+  double geo_route_distance;
+  double curvature;
+  int32_t route_distance;
+  uint32_t is_circular;
+};
+
+struct FlatDistance {
+  uint32_t stop_from;
+  uint32_t stop_to;
+  int32_t distance;
+};
+
+struct FlatRoutingSettings {
+  double bus_velocity;
+  int32_t bus_wait_time;
+  uint32_t router_type;
+  uint32_t graph_model;
+  uint32_t reserved;
+  uint64_t vertex_count;
+};
+
+// Массивы графа хранятся в файле в том же виде, что и в CsrGraph, и используются прямо из отображения
+static_assert(sizeof(graph::VertexId) == sizeof(uint64_t) && sizeof(graph::EdgeId) == sizeof(uint64_t));
+
+// stop_from == NO_STOP - ребро продолжает поездку на том же автобусе
+struct FlatRouterEdge {
+  double time;
+  uint32_t bus;
+  uint32_t stop_from;
+  uint32_t span_count;
+  uint32_t reserved;
+};
+
+struct FlatRouterVertex {
+  uint32_t stop;
+  uint32_t reserved;
+  uint64_t vertex;
+};
+
+struct FlatShortcut {
+  uint64_t from;
+  uint64_t to;
+  double weight;
+  uint64_t first;
+  uint64_t second;
+};
+
+// Кратчайший путь между парой вершин, weight < 0 - пути нет
+struct FlatRoute {
+  double weight;
+  uint64_t prev_edge;
+};
+
+class FlatWriter {
+ public:
+  template<typename T>
+  void SetSection(FlatSection section, ranges::Range<const T *> items) {
+    static_assert(is_trivially_copyable_v<T>);
+    sections_[static_cast<size_t>(section)].assign(reinterpret_cast<const char *>(items.begin()),
+                                                   (items.end() - items.begin()) * sizeof(T));
+  }
+
+  template<typename T>
+  void SetSection(FlatSection section, const vector<T> &items) {
+    SetSection(section, ranges::Range<const T *>(items.data(), items.data() + items.size()));
+  }
+
+  void SetSection(FlatSection section, string bytes) {
+    sections_[static_cast<size_t>(section)] = std::move(bytes);
+  }
+
+  FlatString AddString(string_view str) {
+    auto &strings = sections_[static_cast<size_t>(FlatSection::STRINGS)];
+    FlatString flat_string{strings.size(), str.size()};
+    strings.append(str);
+    return flat_string;
+  }
+
+  void Write(const filesystem::path &path) const {
+    FlatHeader header{FLAT_MAGIC, FLAT_VERSION, static_cast<uint32_t>(SECTION_COUNT)};
+    array<FlatSectionEntry, SECTION_COUNT> entries{};
+    uint64_t offset = Align(sizeof(header) + sizeof(entries));
+    for (size_t i = 0; i < SECTION_COUNT; ++i) {
+      entries[i] = {offset, sections_[i].size()};
+      offset = Align(offset + sections_[i].size());
+    }
+
+    ofstream output(path, ios::binary);
+    if (!output) {
+      throw runtime_error("Cannot open "s + path.string() + " for writing"s);
+    }
+    output.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    output.write(reinterpret_cast<const char *>(entries.data()), sizeof(entries));
+    uint64_t position = sizeof(header) + sizeof(entries);
+    for (size_t i = 0; i < SECTION_COUNT; ++i) {
+      WritePadding(output, entries[i].offset - position);
+      output.write(sections_[i].data(), static_cast<streamsize>(sections_[i].size()));
+      position = entries[i].offset + entries[i].size;
+    }
+    WritePadding(output, offset - position);
+  }
+
+ private:
+  array<string, SECTION_COUNT> sections_;
+
+  static uint64_t Align(uint64_t offset) {
+    return (offset + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT;
+  }
+
+  static void WritePadding(ostream &output, uint64_t size) {
+    static constexpr array<char, SECTION_ALIGNMENT> padding{};
+    output.write(padding.data(), static_cast<streamsize>(size));
+  }
+};
+
+// Отображение файла в память только для чтения. Где mmap недоступен, файл читается целиком
+class MappedFile {
+ public:
+  explicit MappedFile(const filesystem::path &path) {
+#ifdef TC_HAS_MMAP
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+      throw runtime_error("Cannot open "s + path.string());
+    }
+    struct stat file_stat{};
+    if (fstat(fd, &file_stat) == -1) {
+      close(fd);
+      throw runtime_error("Cannot stat "s + path.string());
+    }
+    size_ = static_cast<size_t>(file_stat.st_size);
+    if (size_ > 0) {
+      void *data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data == MAP_FAILED) {
+        close(fd);
+        throw runtime_error("Cannot map "s + path.string());
+      }
+      data_ = static_cast<const char *>(data);
+    }
+    close(fd);
+#else
+    ifstream input(path, ios::binary);
+    if (!input) {
+      throw runtime_error("Cannot open "s + path.string());
+    }
+    buffer_.assign(istreambuf_iterator<char>(input), istreambuf_iterator<char>());
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+#endif
+  }
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  ~MappedFile() {
+#ifdef TC_HAS_MMAP
+    if (data_ != nullptr) {
+      munmap(const_cast<char *>(data_), size_);
+    }
+#endif
+  }
+
+  [[nodiscard]] const char *GetData() const {
+    return data_;
+  }
+
+  [[nodiscard]] size_t GetSize() const {
+    return size_;
+  }
+
+ private:
+  const char *data_ = nullptr;
+  size_t size_ = 0;
+#ifndef TC_HAS_MMAP
+  vector<char> buffer_;
+#endif
+};
+
+class FlatReader {
+ public:
+  explicit FlatReader(const filesystem::path &path) : file_(path) {
+    FlatHeader header{};
+    if (file_.GetSize() < sizeof(header) + sizeof(entries_)) {
+      throw runtime_error("Flat database is truncated"s);
+    }
+    memcpy(&header, file_.GetData(), sizeof(header));
+    if (header.magic != FLAT_MAGIC) {
+      throw runtime_error("Not a flat database"s);
+    }
+    if (header.version != FLAT_VERSION || header.section_count != SECTION_COUNT) {
+      throw runtime_error("Unsupported flat database version "s + to_string(header.version));
+    }
+    memcpy(entries_.data(), file_.GetData() + sizeof(header), sizeof(entries_));
+    for (const auto &entry : entries_) {
+      if (entry.offset % SECTION_ALIGNMENT != 0 || entry.offset > file_.GetSize()
+          || entry.size > file_.GetSize() - entry.offset) {
+        throw runtime_error("Flat database is corrupted"s);
+      }
+    }
+  }
+
+  template<typename T>
+  ranges::Range<const T *> GetSection(FlatSection section) const {
+    static_assert(is_trivially_copyable_v<T> && alignof(T) <= SECTION_ALIGNMENT);
+    const auto &entry = entries_[static_cast<size_t>(section)];
+    if (entry.size % sizeof(T) != 0) {
+      throw runtime_error("Flat database is corrupted"s);
+    }
+    const auto *begin = reinterpret_cast<const T *>(file_.GetData() + entry.offset);
+    return {begin, begin + entry.size / sizeof(T)};
+  }
+
+  [[nodiscard]] string_view GetBytes(FlatSection section) const {
+    const auto &entry = entries_[static_cast<size_t>(section)];
+    return {file_.GetData() + entry.offset, entry.size};
+  }
+
+  [[nodiscard]] string_view GetString(FlatString flat_string) const {
+    const auto strings = GetBytes(FlatSection::STRINGS);
+    if (flat_string.offset > strings.size() || flat_string.size > strings.size() - flat_string.offset) {
+      throw runtime_error("Flat database is corrupted"s);
+    }
+    return strings.substr(flat_string.offset, flat_string.size);
+  }
+
+ private:
+  MappedFile file_;
+  array<FlatSectionEntry, SECTION_COUNT> entries_{};
+};
+
+template<typename T>
+size_t GetSize(const ranges::Range<const T *> &range) {
+  return static_cast<size_t>(range.end() - range.begin());
+}
+
+void WriteCatalogue(FlatWriter &writer, const TransportCatalogue &catalogue) {
+  vector<FlatStop> stops;
+  stops.reserve(catalogue.GetStopCount());
+  for (const auto &stop : catalogue.GetStops()) {
+    stops.push_back({writer.AddString(stop->name), stop->coordinates.lat, stop->coordinates.lng});
+  }
+
+  vector<FlatBus> buses;
+  buses.reserve(catalogue.GetBusCount());
+  vector<StopId> route_stops;
+  for (BusId id = 0; id < catalogue.GetBusCount(); ++id) {
+    const auto &bus = catalogue.GetBus(id);
+    buses.push_back({writer.AddString(bus.name),
+                     route_stops.size(),
+                     bus.stop_ids_on_route.size(),
+                     bus.unique_stops_count,
+                     bus.geo_route_distance,
+                     bus.curvature,
+                     bus.route_distance,
+                     bus.route_type == RouteType::CIRCULAR});
+    route_stops.insert(route_stops.end(), bus.stop_ids_on_route.begin(), bus.stop_ids_on_route.end());
+  }
+
+  vector<FlatDistance> distances;
+  distances.reserve(catalogue.GetAllDistances().size());
+  for (const auto &[stops_pair, distance] : catalogue.GetAllDistances()) {
+    distances.push_back({stops_pair.first, stops_pair.second, distance});
+  }
+
+  writer.SetSection(FlatSection::STOPS, stops);
+  writer.SetSection(FlatSection::BUSES, buses);
+  writer.SetSection(FlatSection::ROUTE_STOPS, route_stops);
+  writer.SetSection(FlatSection::DISTANCES, distances);
+}
+
+void WriteRouter(FlatWriter &writer,
+                 const TransportCatalogue &catalogue,
+                 const TransportRouter &transport_router) {
+  const auto &routing_settings = transport_router.GetRoutingSettings();
+  const auto &graph = transport_router.GetGraph();
+  writer.SetSection(FlatSection::ROUTING_SETTINGS, vector<FlatRoutingSettings>{{
+      routing_settings.bus_velocity,
+      routing_settings.bus_wait_time,
+      static_cast<uint32_t>(routing_settings.router_type),
+      static_cast<uint32_t>(routing_settings.graph_model),
+      0,
+      graph.GetVertexCount()}});
+
+  vector<FlatRouterEdge> router_edges;
+  router_edges.reserve(graph.GetEdgeCount());
+  for (graph::EdgeId id = 0; id < graph.GetEdgeCount(); ++id) {
+    const auto &[bus_route_item, stop_from] = transport_router.GetEdge(id);
+    router_edges.push_back({bus_route_item.time,
+                            catalogue.GetBusId(bus_route_item.bus),
+                            stop_from.empty() ? NO_STOP : catalogue.GetStopId(stop_from),
+                            static_cast<uint32_t>(bus_route_item.span_count),
+                            0});
+  }
+
+  vector<FlatRouterVertex> router_vertexes;
+  for (const auto &stop : catalogue.GetStops()) {
+    if (const auto vertex = transport_router.GetVertexIdByStopName(stop->name)) {
+      router_vertexes.push_back({stop->id, 0, *vertex});
+    }
+  }
+
+  writer.SetSection(FlatSection::GRAPH_EDGES, graph.GetEdges());
+  writer.SetSection(FlatSection::GRAPH_OFFSETS, graph.GetOffsets());
+  writer.SetSection(FlatSection::GRAPH_INCIDENT_EDGES, graph.GetAllIncidentEdges());
+  writer.SetSection(FlatSection::ROUTER_EDGES, router_edges);
+  writer.SetSection(FlatSection::ROUTER_VERTEXES, router_vertexes);
+
+  const auto &router = transport_router.GetRouter();
+  if (const auto *ch_router = get_if<TransportRouter::ContractionHierarchyRouter>(&router)) {
+    const auto &hierarchy = ch_router->GetContractionHierarchy();
+    vector<uint64_t> ranks(hierarchy.ranks.begin(), hierarchy.ranks.end());
+    vector<FlatShortcut> shortcuts;
+    shortcuts.reserve(hierarchy.shortcuts.size());
+    for (const auto &shortcut : hierarchy.shortcuts) {
+      shortcuts.push_back({shortcut.from, shortcut.to, shortcut.weight, shortcut.first, shortcut.second});
+    }
+    writer.SetSection(FlatSection::HIERARCHY_RANKS, ranks);
+    writer.SetSection(FlatSection::HIERARCHY_SHORTCUTS, shortcuts);
+  }
+  const size_t vertex_count = graph.GetVertexCount();
+  const auto *all_pairs_router = get_if<TransportRouter::AllPairsRouter>(&router);
+  // Деление вместо умножения, чтобы не переполнить size_t
+  if (all_pairs_router && (vertex_count == 0 || vertex_count <= MAX_SERIALIZED_ALL_PAIRS_ROUTES / vertex_count)) {
+    vector<FlatRoute> routes;
+    routes.reserve(vertex_count * vertex_count);
+    for (const auto &vertex_routes : all_pairs_router->GetRoutesInternalData()) {
+      for (const auto &route : vertex_routes) {
+        routes.push_back({route ? route->weight : -1., route && route->prev_edge ? *route->prev_edge : NO_EDGE});
+      }
+    }
+    writer.SetSection(FlatSection::ALL_PAIRS_ROUTES, routes);
+  }
+}
+
+void ReadCatalogue(const FlatReader &reader, TransportCatalogue &catalogue) {
+  for (const auto &flat_stop : reader.GetSection<FlatStop>(FlatSection::STOPS)) {
+    Stop stop;
+    stop.name = reader.GetString(flat_stop.name);
+    stop.coordinates = {flat_stop.lat, flat_stop.lng};
+    catalogue.AddStop(std::move(stop));
+  }
+
+  const size_t stop_count = catalogue.GetStopCount();
+  for (const auto &flat_distance : reader.GetSection<FlatDistance>(FlatSection::DISTANCES)) {
+    if (flat_distance.stop_from >= stop_count || flat_distance.stop_to >= stop_count) {
+      throw runtime_error("Flat database is corrupted"s);
+    }
+    catalogue.AddDistance(flat_distance.stop_from, flat_distance.stop_to, flat_distance.distance);
+  }
+
+  const auto route_stops = reader.GetSection<StopId>(FlatSection::ROUTE_STOPS);
+  const size_t route_stops_size = GetSize(route_stops);
+  for (const StopId stop_id : route_stops) {
+    if (stop_id >= stop_count) {
+      throw runtime_error("Flat database is corrupted"s);
+    }
+  }
+  for (const auto &flat_bus : reader.GetSection<FlatBus>(FlatSection::BUSES)) {
+    if (flat_bus.route_offset > route_stops_size || flat_bus.route_size > route_stops_size - flat_bus.route_offset) {
+      throw runtime_error("Flat database is corrupted"s);
+    }
+    Bus bus;
+    bus.name = reader.GetString(flat_bus.name);
+    bus.route_type = flat_bus.is_circular ? RouteType::CIRCULAR : RouteType::LINEAR;
+    bus.stop_ids_on_route.assign(route_stops.begin() + flat_bus.route_offset,
+                                 route_stops.begin() + flat_bus.route_offset + flat_bus.route_size);
+    bus.unique_stops_count = flat_bus.unique_stops_count;
+    bus.geo_route_distance = flat_bus.geo_route_distance;
+    bus.route_distance = flat_bus.route_distance;
+    bus.curvature = flat_bus.curvature;
+    catalogue.AddBusWithRouteStat(std::move(bus));
+  }
+}
+
+RoutingSettings ReadRoutingSettings(const FlatRoutingSettings &flat_settings) {
+  if (flat_settings.router_type > static_cast<uint32_t>(RouterType::CONTRACTION_HIERARCHY)
+      || flat_settings.graph_model > static_cast<uint32_t>(GraphModel::RIDE_VERTICES)) {
+    throw runtime_error("Flat database is corrupted"s);
+  }
+  RoutingSettings routing_settings;
+  routing_settings.bus_velocity = flat_settings.bus_velocity;
+  routing_settings.bus_wait_time = flat_settings.bus_wait_time;
+  routing_settings.router_type = static_cast<RouterType>(flat_settings.router_type);
+  routing_settings.graph_model = static_cast<GraphModel>(flat_settings.graph_model);
+  return routing_settings;
+}
+
+// Граф маршрутизатора использует массивы прямо из отображения файла и продлевает жизнь reader
+TransportRouter ReadRouter(const shared_ptr<const FlatReader> &reader_ptr, const TransportCatalogue &catalogue) {
+  const FlatReader &reader = *reader_ptr;
+  const auto flat_settings = reader.GetSection<FlatRoutingSettings>(FlatSection::ROUTING_SETTINGS);
+  if (GetSize(flat_settings) != 1) {
+    throw runtime_error("Flat database is corrupted"s);
+  }
+  const auto routing_settings = ReadRoutingSettings(*flat_settings.begin());
+  const size_t vertex_count = flat_settings.begin()->vertex_count;
+
+  const auto graph_edges = reader.GetSection<graph::Edge<double>>(FlatSection::GRAPH_EDGES);
+  const auto graph_offsets = reader.GetSection<size_t>(FlatSection::GRAPH_OFFSETS);
+  const auto graph_incident_edges =
+      reader.GetSection<graph::IncidentEdge<double>>(FlatSection::GRAPH_INCIDENT_EDGES);
+  const auto flat_router_edges = reader.GetSection<FlatRouterEdge>(FlatSection::ROUTER_EDGES);
+  const size_t edge_count = GetSize(graph_edges);
+  if (GetSize(flat_router_edges) != edge_count || GetSize(graph_offsets) != vertex_count + 1
+      || !graph::IsValidCsrGraph(graph_edges, graph_offsets, graph_incident_edges)) {
+    throw runtime_error("Flat database is corrupted"s);
+  }
+  TransportRouter::Graph graph(graph_edges, graph_offsets, graph_incident_edges, reader_ptr);
+
+  TransportRouter::Edges router_edges;
+  router_edges.reserve(edge_count);
+  graph::EdgeId edge_id = 0;
+  for (const auto &edge : flat_router_edges) {
+    const string_view stop_from =
+        edge.stop_from == NO_STOP ? string_view{} : string_view(catalogue.GetStop(edge.stop_from).name);
+    router_edges.emplace(edge_id++, make_pair(BusRouteItem(edge.time,
+                                                           catalogue.GetBus(edge.bus).name,
+                                                           static_cast<int>(edge.span_count)),
+                                              stop_from));
+  }
+
+  TransportRouter::Vertexes router_vertexes;
+  for (const auto &vertex : reader.GetSection<FlatRouterVertex>(FlatSection::ROUTER_VERTEXES)) {
+    if (vertex.stop >= catalogue.GetStopCount() || vertex.vertex >= vertex_count) {
+      throw runtime_error("Flat database is corrupted"s);
+    }
+    router_vertexes.emplace(catalogue.GetStop(vertex.stop).name, vertex.vertex);
+  }
+
+  // Иерархия или кратчайшие пути, не подходящие к графу, не используются, как и в формате protobuf,
+  // и строятся заново
+  TransportRouter::RouterIndex router_index;
+  const auto ranks = reader.GetSection<uint64_t>(FlatSection::HIERARCHY_RANKS);
+  if (GetSize(ranks) > 0) {
+    TransportRouter::ContractionHierarchy contraction_hierarchy;
+    contraction_hierarchy.ranks.assign(ranks.begin(), ranks.end());
+    for (const auto &shortcut : reader.GetSection<FlatShortcut>(FlatSection::HIERARCHY_SHORTCUTS)) {
+      contraction_hierarchy.shortcuts.push_back({shortcut.from, shortcut.to, shortcut.weight,
+                                                 shortcut.first, shortcut.second});
+    }
+    if (graph::IsValidContractionHierarchy(contraction_hierarchy, graph)) {
+      router_index = std::move(contraction_hierarchy);
+    }
+  }
+  const auto flat_routes = reader.GetSection<FlatRoute>(FlatSection::ALL_PAIRS_ROUTES);
+  if (GetSize(flat_routes) > 0) {
+    if (GetSize(flat_routes) != vertex_count * vertex_count) {
+      throw runtime_error("Flat database is corrupted"s);
+    }
+    TransportRouter::AllPairsRoutes all_pairs_routes(vertex_count);
+    auto it = flat_routes.begin();
+    for (auto &vertex_routes : all_pairs_routes) {
+      vertex_routes.resize(vertex_count);
+      for (auto &route : vertex_routes) {
+        if (it->weight >= 0.) {
+          route = {it->weight, it->prev_edge == NO_EDGE ? nullopt : optional<graph::EdgeId>(it->prev_edge)};
+        }
+        ++it;
+      }
+    }
+    if (graph::IsValidAllPairsRoutes(all_pairs_routes, graph)) {
+      router_index = std::move(all_pairs_routes);
+    }
+  }
+
+  return {catalogue,
+          routing_settings,
+          std::move(graph),
+          std::move(router_vertexes),
+          std::move(router_edges),
+          std::move(router_index)};
+}
+
+}
+
+bool IsFlatDatabase(const filesystem::path &path) {
+  ifstream input(path, ios::binary);
+  array<char, FLAT_MAGIC.size()> magic{};
+  input.read(magic.data(), magic.size());
+  return input && magic == FLAT_MAGIC;
+}
+
+void SerializeFlat(const filesystem::path &path,
+                   const TransportCatalogue &catalogue,
+                   const RenderSettings &render_settings,
+                   const TransportRouter &transport_router,
+                   const optional<string> &rendered_map) {
+  FlatWriter writer;
+  WriteCatalogue(writer, catalogue);
+  writer.SetSection(FlatSection::RENDER_SETTINGS, SerializeRenderSettings(render_settings).SerializeAsString());
+  WriteRouter(writer, catalogue, transport_router);
+  if (rendered_map) {
+    writer.SetSection(FlatSection::RENDERED_MAP, *rendered_map);
+  }
+  writer.Write(path);
+}
+
+Database DeserializeFlat(const filesystem::path &path, TransportCatalogue &catalogue) {
+  if (catalogue.GetStopCount() > 0 || catalogue.GetBusCount() > 0) {
+    throw invalid_argument("Flat database can only be loaded into an empty catalogue"s);
+  }
+  const auto reader_ptr = make_shared<const FlatReader>(path);
+  const FlatReader &reader = *reader_ptr;
+  ReadCatalogue(reader, catalogue);
+
+  // Настройки отрисовки занимают сотни байт и хранятся в файле сообщением protobuf
+  proto_tc::RenderSettings proto_render_settings;
+  const auto render_settings_bytes = reader.GetBytes(FlatSection::RENDER_SETTINGS);
+  if (!proto_render_settings.ParseFromArray(render_settings_bytes.data(),
+                                            static_cast<int>(render_settings_bytes.size()))) {
+    throw runtime_error("Flat database is corrupted"s);
+  }
+  // Пустая секция - карта не сохранялась, текст SVG пустым не бывает
+  const auto rendered_map = reader.GetBytes(FlatSection::RENDERED_MAP);
+  return {DeserializeRenderSettings(proto_render_settings),
+          ReadRouter(reader_ptr, catalogue),
+          rendered_map.empty() ? nullopt : optional<string>(rendered_map)};
+}
+
+}
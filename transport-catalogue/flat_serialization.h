@@ -0,0 +1,32 @@
+#pragma once
+
+#include "transport_catalogue.h"
+#include "map_renderer.h"
+#include "transport_router.h"
+
+#include <filesystem>
+#include <optional>
+#include <string>
+
+namespace serialization {
+
+struct Database;
+
+// Плоский формат базы: заголовок, таблица секций и секции-массивы структур фиксированного
+// размера (остановки, автобусы со статистикой, остановки маршрутов, расстояния, массивы
+// графа CSR, данные рёбер маршрутизатора, иерархия сжатия). Файл читается через mmap:
+// граф маршрутизатора работает прямо поверх отображения без копирования и перестроения,
+// остальные массивы переносятся в справочник и таблицы маршрутизатора без разбора и без
+// пересчёта статистики, поэтому загрузка всё ещё линейна по числу остановок, автобусов и рёбер.
+// Порядок байт и выравнивание - как у машины, на которой база создана
+bool IsFlatDatabase(const std::filesystem::path &path);
+
+void SerializeFlat(const std::filesystem::path &path,
+                   const transport_catalogue::TransportCatalogue &catalogue,
+                   const renderer::RenderSettings &render_settings,
+                   const routing::TransportRouter &transport_router,
+                   const std::optional<std::string> &rendered_map = std::nullopt);
+
+Database DeserializeFlat(const std::filesystem::path &path, transport_catalogue::TransportCatalogue &catalogue);
+
+}
@@ -3,6 +3,8 @@
 #include "ranges.h"
 
 #include <cstdlib>
+#include <memory>
+#include <stdexcept>
 #include <vector>
 
 namespace graph {
@@ -17,6 +19,28 @@ struct Edge {
   Weight weight;
 };
 
+// Исходящее ребро CsrGraph вместе с концом и весом, чтобы при обходе соседей
+// не обращаться к общему массиву рёбер
+template<typename Weight>
+struct IncidentEdge {
+  EdgeId id;
+  VertexId to;
+  Weight weight;
+};
+
+// Приводит элемент GetIncidentEdges к IncidentEdge: DirectedWeightedGraph перечисляет номера рёбер,
+// CsrGraph - сами рёбра
+template<typename Weight, typename Graph>
+IncidentEdge<Weight> GetIncidentEdge(const Graph &graph, EdgeId edge_id) {
+  const auto &edge = graph.GetEdge(edge_id);
+  return {edge_id, edge.to, edge.weight};
+}
+
+template<typename Weight, typename Graph>
+const IncidentEdge<Weight> &GetIncidentEdge(const Graph &, const IncidentEdge<Weight> &edge) {
+  return edge;
+}
+
 template<typename Weight>
 class DirectedWeightedGraph {
  private:
@@ -72,4 +96,191 @@ DirectedWeightedGraph<Weight>::GetIncidentEdges(VertexId vertex) const {
   return ranges::AsRange(incidence_lists_.at(vertex));
 }
 
+// Проверяет, что массивы CSR, например отображённые из файла, согласованы: offsets - границы рёбер
+// каждой вершины, а исходящие рёбра вершины совпадают с рёбрами edges, начинающимися в ней,
+// и перечислены в порядке номеров
+template<typename Weight>
+bool IsValidCsrGraph(ranges::Range<const Edge<Weight> *> edges,
+                     ranges::Range<const size_t *> offsets,
+                     ranges::Range<const IncidentEdge<Weight> *> incident_edges) {
+  const size_t edge_count = edges.end() - edges.begin();
+  const size_t offset_count = offsets.end() - offsets.begin();
+  if (offset_count == 0 || offsets.begin()[0] != 0 || offsets.begin()[offset_count - 1] != edge_count
+      || static_cast<size_t>(incident_edges.end() - incident_edges.begin()) != edge_count) {
+    return false;
+  }
+  const size_t vertex_count = offset_count - 1;
+  for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+    const size_t begin = offsets.begin()[vertex];
+    const size_t end = offsets.begin()[vertex + 1];
+    if (begin > end || end > edge_count) {
+      return false;
+    }
+    for (size_t i = begin; i < end; ++i) {
+      const auto &incident_edge = incident_edges.begin()[i];
+      if (incident_edge.id >= edge_count || (i > begin && incident_edge.id <= incident_edges.begin()[i - 1].id)) {
+        return false;
+      }
+      const auto &edge = edges.begin()[incident_edge.id];
+      if (edge.from != vertex || edge.to >= vertex_count || edge.to != incident_edge.to
+          || edge.weight != incident_edge.weight) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Замороженный граф в формате CSR: исходящие рёбра всех вершин лежат подряд
+// в одном массиве, а offsets_[v] указывает начало рёбер вершины v.
+// Номера рёбер совпадают с номерами в исходном DirectedWeightedGraph.
+// Массивы неизменяемы и разделяются копиями графа, а граф может быть построен
+// поверх чужой памяти, например отображённого файла
+template<typename Weight>
+class CsrGraph {
+ private:
+  using IncidentEdgesRange = ranges::Range<const IncidentEdge<Weight> *>;
+
+ public:
+  CsrGraph() = default;
+  explicit CsrGraph(const DirectedWeightedGraph<Weight> &graph);
+  CsrGraph(size_t vertex_count, std::vector<Edge<Weight>> edges);
+  // Граф поверх готовых массивов без копирования, storage владеет их памятью
+  CsrGraph(ranges::Range<const Edge<Weight> *> edges,
+           ranges::Range<const size_t *> offsets,
+           ranges::Range<const IncidentEdge<Weight> *> incident_edges,
+           std::shared_ptr<const void> storage);
+
+  size_t GetVertexCount() const;
+  size_t GetEdgeCount() const;
+  const Edge<Weight> &GetEdge(EdgeId edge_id) const;
+  IncidentEdgesRange GetIncidentEdges(VertexId vertex) const;
+
+  // Массивы графа целиком, например для сохранения
+  ranges::Range<const Edge<Weight> *> GetEdges() const;
+  ranges::Range<const size_t *> GetOffsets() const;
+  IncidentEdgesRange GetAllIncidentEdges() const;
+
+ private:
+  struct Arrays {
+    std::vector<Edge<Weight>> edges;
+    std::vector<size_t> offsets;
+    std::vector<IncidentEdge<Weight>> incident_edges;
+  };
+
+  std::shared_ptr<const void> storage_;
+  const Edge<Weight> *edges_ = nullptr;
+  const size_t *offsets_ = nullptr;
+  const IncidentEdge<Weight> *incident_edges_ = nullptr;
+  size_t vertex_count_ = 0;
+  size_t edge_count_ = 0;
+
+  void BuildIncidentEdges(size_t vertex_count, std::vector<Edge<Weight>> edges);
+};
+
+template<typename Weight>
+CsrGraph<Weight>::CsrGraph(const DirectedWeightedGraph<Weight> &graph) {
+  std::vector<Edge<Weight>> edges;
+  edges.reserve(graph.GetEdgeCount());
+  for (EdgeId edge_id = 0; edge_id < graph.GetEdgeCount(); ++edge_id) {
+    edges.push_back(graph.GetEdge(edge_id));
+  }
+  BuildIncidentEdges(graph.GetVertexCount(), std::move(edges));
+}
+
+template<typename Weight>
+CsrGraph<Weight>::CsrGraph(size_t vertex_count, std::vector<Edge<Weight>> edges) {
+  BuildIncidentEdges(vertex_count, std::move(edges));
+}
+
+template<typename Weight>
+CsrGraph<Weight>::CsrGraph(ranges::Range<const Edge<Weight> *> edges,
+                           ranges::Range<const size_t *> offsets,
+                           ranges::Range<const IncidentEdge<Weight> *> incident_edges,
+                           std::shared_ptr<const void> storage)
+    : storage_(std::move(storage)),
+      edges_(edges.begin()),
+      offsets_(offsets.begin()),
+      incident_edges_(incident_edges.begin()),
+      edge_count_(edges.end() - edges.begin()) {
+  if (!IsValidCsrGraph(edges, offsets, incident_edges)) {
+    throw std::invalid_argument("CSR arrays are inconsistent");
+  }
+  vertex_count_ = offsets.end() - offsets.begin() - 1;
+}
+
+template<typename Weight>
+void CsrGraph<Weight>::BuildIncidentEdges(size_t vertex_count, std::vector<Edge<Weight>> edges) {
+  // Сортировка подсчётом сохраняет порядок рёбер внутри вершины таким же,
+  // как в списках смежности DirectedWeightedGraph
+  auto arrays = std::make_shared<Arrays>();
+  arrays->edges = std::move(edges);
+  auto &offsets = arrays->offsets;
+  offsets.assign(vertex_count + 1, 0);
+  for (const auto &edge : arrays->edges) {
+    if (edge.from >= vertex_count) {
+      throw std::out_of_range("Edge starts outside of the graph");
+    }
+    ++offsets[edge.from + 1];
+  }
+  for (size_t vertex = 0; vertex < vertex_count; ++vertex) {
+    offsets[vertex + 1] += offsets[vertex];
+  }
+  std::vector<size_t> positions(offsets.begin(), offsets.end() - 1);
+  arrays->incident_edges.resize(arrays->edges.size());
+  for (EdgeId edge_id = 0; edge_id < arrays->edges.size(); ++edge_id) {
+    const auto &edge = arrays->edges[edge_id];
+    arrays->incident_edges[positions[edge.from]++] = {edge_id, edge.to, edge.weight};
+  }
+
+  edges_ = arrays->edges.data();
+  offsets_ = offsets.data();
+  incident_edges_ = arrays->incident_edges.data();
+  vertex_count_ = vertex_count;
+  edge_count_ = arrays->edges.size();
+  storage_ = std::move(arrays);
+}
+
+template<typename Weight>
+size_t CsrGraph<Weight>::GetVertexCount() const {
+  return vertex_count_;
+}
+
+template<typename Weight>
+size_t CsrGraph<Weight>::GetEdgeCount() const {
+  return edge_count_;
+}
+
+template<typename Weight>
+const Edge<Weight> &CsrGraph<Weight>::GetEdge(EdgeId edge_id) const {
+  if (edge_id >= edge_count_) {
+    throw std::out_of_range("Edge is out of range");
+  }
+  return edges_[edge_id];
+}
+
+template<typename Weight>
+typename CsrGraph<Weight>::IncidentEdgesRange
+CsrGraph<Weight>::GetIncidentEdges(VertexId vertex) const {
+  if (vertex >= vertex_count_) {
+    throw std::out_of_range("Vertex is out of range");
+  }
+  return {incident_edges_ + offsets_[vertex], incident_edges_ + offsets_[vertex + 1]};
+}
+
+template<typename Weight>
+ranges::Range<const Edge<Weight> *> CsrGraph<Weight>::GetEdges() const {
+  return {edges_, edges_ + edge_count_};
+}
+
+template<typename Weight>
+ranges::Range<const size_t *> CsrGraph<Weight>::GetOffsets() const {
+  return {offsets_, offsets_ == nullptr ? offsets_ : offsets_ + vertex_count_ + 1};
+}
+
+template<typename Weight>
+typename CsrGraph<Weight>::IncidentEdgesRange CsrGraph<Weight>::GetAllIncidentEdges() const {
+  return {incident_edges_, incident_edges_ + edge_count_};
+}
+
 }  // namespace graph
\ No newline at end of file
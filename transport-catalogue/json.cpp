@@ -1,5 +1,9 @@
 #include "json.h"
 
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+
 using namespace std;
 
 namespace json {
@@ -209,10 +213,363 @@ Node LoadNode(istream &input) {
   }
 }
 
+void ParseNode(istream &input, Handler &handler);
+
+void ParseArray(istream &input, Handler &handler) {
+  handler.StartArray();
+  for (char c; input >> c && c != ']';) {
+    if (c != ',') {
+      input.putback(c);
+    }
+    ParseNode(input, handler);
+  }
+
+  if (!input) {
+    throw ParsingError("Array parsing error"s);
+  }
+  handler.EndArray();
+}
+
+void ParseDict(istream &input, Handler &handler) {
+  handler.StartDict();
+  for (char c; input >> c && c != '}';) {
+    if (c == ',') {
+      input >> c;
+    }
+
+    handler.Key(LoadString(input).AsString());
+    input >> c;
+    ParseNode(input, handler);
+  }
+
+  if (!input) {
+    throw ParsingError("Dict parsing error"s);
+  }
+  handler.EndDict();
+}
+
+void ParseNode(istream &input, Handler &handler) {
+  char c;
+  input >> c;
+
+  switch (c) {
+    case '[':ParseArray(input, handler);
+      break;
+    case '{':ParseDict(input, handler);
+      break;
+    default:input.putback(c);
+      handler.Value(LoadNode(input));
+      break;
+  }
+}
+
+// Лексический разбор документа, целиком находящегося в памяти. Грамматика и ошибки те же,
+// что при чтении из потока, но символы читаются по указателю, а числа преобразуются
+// через from_chars без промежуточной строки
+class BufferScanner {
+ public:
+  BufferScanner(const char *begin, const char *end) : pos_(begin), end_(end) {}
+
+ protected:
+  const char *pos_;
+  const char *end_;
+
+  // Возвращает очередной непробельный символ, как operator>> для потока
+  char GetNonSpace(const string &error) {
+    while (pos_ != end_ && isspace(static_cast<unsigned char>(*pos_))) {
+      ++pos_;
+    }
+    if (pos_ == end_) {
+      throw ParsingError(error);
+    }
+    return *pos_++;
+  }
+
+  [[nodiscard]] bool IsDigit() const {
+    return pos_ != end_ && isdigit(static_cast<unsigned char>(*pos_));
+  }
+
+  void SkipDigits() {
+    if (!IsDigit()) {
+      throw ParsingError("A digit is expected"s);
+    }
+    while (IsDigit()) {
+      ++pos_;
+    }
+  }
+
+  variant<int, double> ScanNumber() {
+    const char *start = pos_;
+    if (pos_ != end_ && *pos_ == '-') {
+      ++pos_;
+    }
+    // После 0 в JSON не могут идти другие цифры
+    if (pos_ != end_ && *pos_ == '0') {
+      ++pos_;
+    } else {
+      SkipDigits();
+    }
+
+    bool is_int = true;
+    if (pos_ != end_ && *pos_ == '.') {
+      ++pos_;
+      SkipDigits();
+      is_int = false;
+    }
+    if (pos_ != end_ && (*pos_ == 'e' || *pos_ == 'E')) {
+      ++pos_;
+      if (pos_ != end_ && (*pos_ == '+' || *pos_ == '-')) {
+        ++pos_;
+      }
+      SkipDigits();
+      is_int = false;
+    }
+
+    if (is_int) {
+      int value = 0;
+      // При переполнении int число читается как double
+      if (const auto [ptr, ec] = from_chars(start, pos_, value); ec == errc{}) {
+        return value;
+      }
+    }
+    double value = 0.;
+    if (const auto [ptr, ec] = from_chars(start, pos_, value); ec != errc{}) {
+      throw ParsingError("Failed to convert "s + string(start, pos_) + " to number"s);
+    }
+    return value;
+  }
+
+  // Пропускает символы строкового литерала, не требующие обработки. Проверяется сразу
+  // по восемь байт: байт, равный искомому, обращается в ноль и обнаруживается битовыми операциями
+  void SkipPlainChars() {
+    constexpr uint64_t ONES = 0x0101010101010101ULL;
+    constexpr uint64_t HIGHS = 0x8080808080808080ULL;
+    const auto has_byte = [](uint64_t word, char ch) {
+      const uint64_t x = word ^ (ONES * static_cast<unsigned char>(ch));
+      return ((x - ONES) & ~x & HIGHS) != 0;
+    };
+    while (end_ - pos_ >= static_cast<ptrdiff_t>(sizeof(uint64_t))) {
+      uint64_t word;
+      memcpy(&word, pos_, sizeof(word));
+      if (has_byte(word, '"') || has_byte(word, '\\') || has_byte(word, '\n') || has_byte(word, '\r')) {
+        break;
+      }
+      pos_ += sizeof(word);
+    }
+    while (pos_ != end_ && *pos_ != '"' && *pos_ != '\\' && *pos_ != '\n' && *pos_ != '\r') {
+      ++pos_;
+    }
+  }
+
+  // Вызывается после считывания открывающей кавычки. Содержимое строки передаётся в append
+  // кусками: отрезками исходного текста и отдельными символами escape-последовательностей
+  template<typename Append>
+  void ScanString(Append append) {
+    while (true) {
+      const char *start = pos_;
+      SkipPlainChars();
+      append(string_view(start, pos_ - start));
+      if (pos_ == end_) {
+        throw ParsingError("String parsing error");
+      }
+      const char ch = *pos_++;
+      if (ch == '"') {
+        return;
+      }
+      if (ch == '\n' || ch == '\r') {
+        throw ParsingError("Unexpected end of line"s);
+      }
+      if (pos_ == end_) {
+        throw ParsingError("String parsing error");
+      }
+      const char escaped_char = *pos_++;
+      char unescaped_char;
+      switch (escaped_char) {
+        case 'n':unescaped_char = '\n';
+          break;
+        case 't':unescaped_char = '\t';
+          break;
+        case 'r':unescaped_char = '\r';
+          break;
+        case '"':unescaped_char = '"';
+          break;
+        case '\\':unescaped_char = '\\';
+          break;
+        default:throw ParsingError("Unrecognized escape sequence \\"s + escaped_char);
+      }
+      append(string_view(&unescaped_char, 1));
+    }
+  }
+
+  string_view GetWord() {
+    const char *start = pos_;
+    while (pos_ != end_ && isalpha(static_cast<unsigned char>(*pos_))) {
+      ++pos_;
+    }
+    return {start, static_cast<size_t>(pos_ - start)};
+  }
+
+  void ScanNull() {
+    if (GetWord() != "null"sv) {
+      throw ParsingError("Null parsing error"s);
+    }
+  }
+
+  bool ScanBool() {
+    const auto word = GetWord();
+    if (word == "true"sv) {
+      return true;
+    }
+    if (word == "false"sv) {
+      return false;
+    }
+    throw ParsingError("Boolean parsing error"s);
+  }
+};
+
+class BufferParser : BufferScanner {
+ public:
+  explicit BufferParser(string_view input) : BufferScanner(input.data(), input.data() + input.size()) {}
+
+  Node LoadNode() {
+    const char c = GetNonSpace("A digit is expected"s);
+    switch (c) {
+      case '[':return LoadArray();
+      case '{':return LoadDict();
+      case '"':return LoadString();
+      case 'n':--pos_;
+        ScanNull();
+        return Node(nullptr);
+      case 'f':[[fallthrough]];
+      case 't':--pos_;
+        return Node(ScanBool());
+      default:--pos_;
+        return visit([](auto value) { return Node(value); }, ScanNumber());
+    }
+  }
+
+ private:
+  Node LoadString() {
+    string s;
+    ScanString([&s](string_view chunk) { s.append(chunk); });
+    return Node(std::move(s));
+  }
+
+  Node LoadArray() {
+    Array result;
+    for (char c; (c = GetNonSpace("Array parsing error"s)) != ']';) {
+      if (c != ',') {
+        --pos_;
+      }
+      result.push_back(LoadNode());
+    }
+    return Node(std::move(result));
+  }
+
+  Node LoadDict() {
+    Dict result;
+    for (char c; (c = GetNonSpace("Dict parsing error"s)) != '}';) {
+      if (c == ',') {
+        GetNonSpace("Dict parsing error"s);
+      }
+      string key = LoadString().AsString();
+      GetNonSpace("Dict parsing error"s);
+      result.insert({std::move(key), LoadNode()});
+    }
+    return Node(std::move(result));
+  }
+};
+
+// Разбирает документ в плоский массив узлов. Строки раскодируются на месте в копии исходного текста:
+// раскодированная строка не длиннее записи в тексте, поэтому не затирает ещё не прочитанные символы
+class FlatParser : BufferScanner {
+ public:
+  using Item = FlatDocument::Item;
+  using Type = FlatDocument::Type;
+
+  FlatParser(char *buffer, size_t size, vector<Item> &items)
+      : BufferScanner(buffer, buffer + size), buffer_(buffer), items_(items) {}
+
+  void ParseNode() {
+    const char c = GetNonSpace("A digit is expected"s);
+    switch (c) {
+      case '[':ParseContainer(Type::ARRAY);
+        break;
+      case '{':ParseContainer(Type::DICT);
+        break;
+      case '"':AddLeaf(Type::STRING).string_value = ParseString();
+        break;
+      case 'n':--pos_;
+        ScanNull();
+        AddLeaf(Type::NUL);
+        break;
+      case 'f':[[fallthrough]];
+      case 't':--pos_;
+        AddLeaf(Type::BOOL).int_value = ScanBool();
+        break;
+      default:--pos_;
+        const auto number = ScanNumber();
+        if (holds_alternative<int>(number)) {
+          AddLeaf(Type::INT).int_value = get<int>(number);
+        } else {
+          AddLeaf(Type::DOUBLE).double_value = get<double>(number);
+        }
+        break;
+    }
+  }
+
+ private:
+  char *buffer_;
+  vector<Item> &items_;
+
+  // Поля узла, кроме типа и next, получают значения по умолчанию
+  Item &AddLeaf(Type type) {
+    auto &item = items_.emplace_back();
+    item.type = type;
+    item.next = static_cast<uint32_t>(items_.size());
+    return item;
+  }
+
+  string_view ParseString() {
+    char *const start = buffer_ + (pos_ - buffer_);
+    char *out = start;
+    ScanString([&out](string_view chunk) {
+      memmove(out, chunk.data(), chunk.size());
+      out += chunk.size();
+    });
+    return {start, static_cast<size_t>(out - start)};
+  }
+
+  // Словарь хранится как чередование узлов ключей и поддеревьев значений
+  void ParseContainer(Type type) {
+    const size_t index = items_.size();
+    items_.emplace_back().type = type;
+    const bool is_dict = type == Type::DICT;
+    const string error = is_dict ? "Dict parsing error"s : "Array parsing error"s;
+    uint32_t size = 0;
+    for (char c; (c = GetNonSpace(error)) != (is_dict ? '}' : ']'); ++size) {
+      if (is_dict) {
+        if (c == ',') {
+          GetNonSpace(error);
+        }
+        AddLeaf(Type::STRING).string_value = ParseString();
+        GetNonSpace(error);
+      } else if (c != ',') {
+        --pos_;
+      }
+      ParseNode();
+    }
+    items_[index].size = size;
+    items_[index].next = static_cast<uint32_t>(items_.size());
+  }
+};
+
 }  // namespace
 
 const Node::Value &Node::GetValue() const { return *this; }
 
+Node::Value &Node::GetValue() { return *this; }
+
 bool Node::IsInt() const {
   return holds_alternative<int>(*this);
 }
@@ -310,6 +667,146 @@ Document Load(istream &input) {
   return Document{LoadNode(input)};
 }
 
+Document Load(string_view input) {
+  return Document{BufferParser(input).LoadNode()};
+}
+
+void Parse(istream &input, Handler &handler) {
+  ParseNode(input, handler);
+}
+
+FlatDocument::FlatDocument(string source)
+    : source_(std::move(source)) {
+  FlatParser(source_.data(), source_.size(), items_).ParseNode();
+}
+
+FlatDocument::NodeRef FlatDocument::GetRoot() const {
+  return {*this, 0};
+}
+
+size_t FlatDocument::GetItemCount() const {
+  return items_.size();
+}
+
+FlatDocument::NodeRef::NodeRef(const FlatDocument &document, uint32_t index)
+    : document_(&document), index_(index) {}
+
+const FlatDocument::Item &FlatDocument::NodeRef::GetItem() const {
+  return document_->items_[index_];
+}
+
+bool FlatDocument::NodeRef::IsInt() const {
+  return GetItem().type == Type::INT;
+}
+
+bool FlatDocument::NodeRef::IsDouble() const {
+  return GetItem().type == Type::DOUBLE || GetItem().type == Type::INT;
+}
+
+bool FlatDocument::NodeRef::IsPureDouble() const {
+  return GetItem().type == Type::DOUBLE;
+}
+
+bool FlatDocument::NodeRef::IsBool() const {
+  return GetItem().type == Type::BOOL;
+}
+
+bool FlatDocument::NodeRef::IsString() const {
+  return GetItem().type == Type::STRING;
+}
+
+bool FlatDocument::NodeRef::IsNull() const {
+  return GetItem().type == Type::NUL;
+}
+
+bool FlatDocument::NodeRef::IsArray() const {
+  return GetItem().type == Type::ARRAY;
+}
+
+bool FlatDocument::NodeRef::IsMap() const {
+  return GetItem().type == Type::DICT;
+}
+
+int FlatDocument::NodeRef::AsInt() const {
+  if (!IsInt()) {
+    throw logic_error("Not int"s);
+  }
+  return GetItem().int_value;
+}
+
+double FlatDocument::NodeRef::AsDouble() const {
+  if (IsPureDouble()) {
+    return GetItem().double_value;
+  }
+  if (IsInt()) {
+    return GetItem().int_value;
+  }
+  throw logic_error("Not double"s);
+}
+
+string_view FlatDocument::NodeRef::AsString() const {
+  if (!IsString()) {
+    throw logic_error("Not string"s);
+  }
+  return GetItem().string_value;
+}
+
+bool FlatDocument::NodeRef::AsBool() const {
+  if (!IsBool()) {
+    throw logic_error("Not boolean"s);
+  }
+  return GetItem().int_value != 0;
+}
+
+size_t FlatDocument::NodeRef::GetSize() const {
+  if (!IsArray() && !IsMap()) {
+    throw logic_error("Not container"s);
+  }
+  return GetItem().size;
+}
+
+optional<FlatDocument::NodeRef> FlatDocument::NodeRef::Find(string_view key) const {
+  if (!IsMap()) {
+    throw logic_error("Not dict"s);
+  }
+  const auto &items = document_->items_;
+  for (uint32_t index = index_ + 1; index < GetItem().next; index = items[index + 1].next) {
+    if (items[index].string_value == key) {
+      return NodeRef(*document_, index + 1);
+    }
+  }
+  return nullopt;
+}
+
+FlatDocument::NodeRef FlatDocument::NodeRef::At(string_view key) const {
+  if (const auto value = Find(key)) {
+    return *value;
+  }
+  throw out_of_range("No key "s + string(key));
+}
+
+Node FlatDocument::NodeRef::ToNode() const {
+  switch (GetItem().type) {
+    case Type::NUL:return Node(nullptr);
+    case Type::BOOL:return Node(AsBool());
+    case Type::INT:return Node(AsInt());
+    case Type::DOUBLE:return Node(AsDouble());
+    case Type::STRING:return Node(string(AsString()));
+    case Type::ARRAY: {
+      Array result;
+      result.reserve(GetSize());
+      ForEachItem([&result](NodeRef item) { result.push_back(item.ToNode()); });
+      return Node(std::move(result));
+    }
+    case Type::DICT: {
+      Dict result;
+      ForEachEntry([&result](string_view key, NodeRef value) { result.emplace(string(key), value.ToNode()); });
+      return Node(std::move(result));
+    }
+  }
+  return Node(nullptr);
+}
+
 bool Document::operator==(const Document& right) const {
   return this->GetRoot() == right.GetRoot();
 }
@@ -345,6 +842,20 @@ void PrintValue(const std::string &value, const PrintContext &ctx) {
 }
 
 void PrintValue(const Array &value, const PrintContext &ctx) {
+  if (ctx.compact) {
+    ctx.out << "["sv;
+    bool first = true;
+    for (const auto &node : value) {
+      if (first) {
+        first = false;
+      } else {
+        ctx.out << ","sv;
+      }
+      PrintNode(node, ctx);
+    }
+    ctx.out << "]"sv;
+    return;
+  }
   ctx.out << "[\n"sv;
   auto next_ctx = ctx.Indented();
   bool first = true;
@@ -363,6 +874,22 @@ void PrintValue(const Array &value, const PrintContext &ctx) {
 }
 
 void PrintValue(const Dict &value, const PrintContext &ctx) {
+  if (ctx.compact) {
+    ctx.out << "{"sv;
+    bool first = true;
+    for (const auto &[key, node] : value) {
+      if (first) {
+        first = false;
+      } else {
+        ctx.out << ","sv;
+      }
+      PrintValue(key, ctx);
+      ctx.out << ":"sv;
+      PrintNode(node, ctx);
+    }
+    ctx.out << "}"sv;
+    return;
+  }
   ctx.out << "{\n"sv;
   auto next_ctx = ctx.Indented();
   bool first = true;
@@ -392,4 +919,8 @@ void Print(const Document &doc, std::ostream &output) {
   PrintNode(doc.GetRoot(), PrintContext{output});
 }
 
+void PrintCompact(const Document &doc, std::ostream &output) {
+  PrintNode(doc.GetRoot(), PrintContext{output, 0, 0, true});
+}
+
 }  // namespace json
\ No newline at end of file
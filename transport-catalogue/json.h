@@ -1,8 +1,12 @@
 #pragma once
 
+#include <cstdint>
 #include <iostream>
 #include <map>
+#include <optional>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <variant>
 
@@ -27,6 +31,7 @@ class Node final
   using Value = variant;
 
   const Value &GetValue() const;
+  Value &GetValue();
 
   bool IsInt() const;
   bool IsDouble() const;
@@ -52,6 +57,8 @@ struct PrintContext {
   std::ostream &out;
   int indent_step = 4;
   int indent = 0;
+  // Массивы и словари выводятся в одну строку без отступов
+  bool compact = false;
 
   void PrintIndent() const {
     for (int i = 0; i < indent; ++i) {
@@ -61,7 +68,7 @@ struct PrintContext {
 
   // Возвращает новый контекст вывода с увеличенным смещением
   [[nodiscard]] PrintContext Indented() const {
-    return {out, indent_step, indent_step + indent};
+    return {out, indent_step, indent_step + indent, compact};
   }
 };
 
@@ -82,6 +89,123 @@ class Document {
 
 Document Load(std::istream &input);
 
+// Разбирает документ, целиком прочитанный в память. Результат совпадает с чтением из потока
+Document Load(std::string_view input);
+
+// Обработчик событий потокового разбора JSON. События приходят в порядке следования
+// элементов в документе, дерево узлов при этом не строится
+class Handler {
+ public:
+  virtual ~Handler() = default;
+
+  virtual void StartDict() = 0;
+  virtual void Key(std::string key) = 0;
+  virtual void EndDict() = 0;
+  virtual void StartArray() = 0;
+  virtual void EndArray() = 0;
+  // Скалярное значение: null, bool, int, double или строка
+  virtual void Value(Node value) = 0;
+};
+
+void Parse(std::istream &input, Handler &handler);
+
+// Документ, разобранный в плоский массив узлов: поддерево узла занимает непрерывный отрезок массива,
+// а строки ссылаются на исходный текст, которым документ владеет. Разбор выделяет несколько крупных блоков
+// памяти вместо узла на каждый элемент, и весь документ освобождается разом.
+// Документ не копируется и не перемещается: при перемещении короткой строки её символы меняют адрес
+class FlatDocument {
+ public:
+  enum class Type : std::uint8_t { NUL, BOOL, INT, DOUBLE, STRING, ARRAY, DICT };
+
+  struct Item {
+    Type type = Type::NUL;
+    // Для массива - число элементов, для словаря - число пар ключ-значение
+    std::uint32_t size = 0;
+    // Номер узла, следующего за поддеревом
+    std::uint32_t next = 0;
+    int int_value = 0;
+    double double_value = 0.;
+    std::string_view string_value;
+  };
+
+  class NodeRef {
+   public:
+    NodeRef(const FlatDocument &document, std::uint32_t index);
+
+    bool IsInt() const;
+    bool IsDouble() const;
+    bool IsPureDouble() const;
+    bool IsBool() const;
+    bool IsString() const;
+    bool IsNull() const;
+    bool IsArray() const;
+    bool IsMap() const;
+
+    int AsInt() const;
+    double AsDouble() const;
+    std::string_view AsString() const;
+    bool AsBool() const;
+
+    // Число элементов массива или пар словаря
+    [[nodiscard]] size_t GetSize() const;
+
+    // Значение по ключу словаря, при повторе ключа - первое, как в Load
+    [[nodiscard]] std::optional<NodeRef> Find(std::string_view key) const;
+    [[nodiscard]] NodeRef At(std::string_view key) const;
+
+    // Вызывает action(NodeRef) для каждого элемента массива
+    template<typename Action>
+    void ForEachItem(Action action) const;
+
+    // Вызывает action(std::string_view, NodeRef) для каждой пары словаря
+    template<typename Action>
+    void ForEachEntry(Action action) const;
+
+    // Копирует поддерево в обычный узел
+    [[nodiscard]] Node ToNode() const;
+
+   private:
+    const FlatDocument *document_;
+    std::uint32_t index_;
+
+    [[nodiscard]] const Item &GetItem() const;
+  };
+
+  // Текст разбирается на месте, поэтому прочитанный вход лучше передавать перемещением, без копии
+  explicit FlatDocument(std::string source);
+
+  FlatDocument(const FlatDocument &) = delete;
+  FlatDocument &operator=(const FlatDocument &) = delete;
+
+  [[nodiscard]] NodeRef GetRoot() const;
+
+  [[nodiscard]] size_t GetItemCount() const;
+
+ private:
+  std::string source_;
+  std::vector<Item> items_;
+};
+
+template<typename Action>
+void FlatDocument::NodeRef::ForEachItem(Action action) const {
+  if (!IsArray()) {
+    throw std::logic_error("Not array");
+  }
+  for (std::uint32_t index = index_ + 1; index < GetItem().next; index = document_->items_[index].next) {
+    action(NodeRef(*document_, index));
+  }
+}
+
+template<typename Action>
+void FlatDocument::NodeRef::ForEachEntry(Action action) const {
+  if (!IsMap()) {
+    throw std::logic_error("Not dict");
+  }
+  for (std::uint32_t index = index_ + 1; index < GetItem().next; index = document_->items_[index + 1].next) {
+    action(document_->items_[index].string_value, NodeRef(*document_, index + 1));
+  }
+}
+
 void PrintValue(std::nullptr_t, const PrintContext &ctx);
 
 void PrintValue(bool value, const PrintContext &ctx);
@@ -101,4 +225,7 @@ void PrintNode(const Node &node, const PrintContext &ctx);
 
 void Print(const Document &doc, std::ostream &output);
 
+// Выводит документ в одну строку
+void PrintCompact(const Document &doc, std::ostream &output);
+
 }  // namespace json
\ No newline at end of file
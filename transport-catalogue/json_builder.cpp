@@ -60,12 +60,12 @@ void Builder::BuildNode(std::string &&action_type) {
   if (nodes_stack_.empty()) {
     throw logic_error("Invalid "s + action_type);
   }
-  auto node = *nodes_stack_.back().release();
+  auto node = std::move(*nodes_stack_.back());
   nodes_stack_.pop_back();
   if (root_.IsNull() && nodes_stack_.empty()) {
     root_ = std::move(node);
   } else if (!nodes_stack_.empty() && nodes_stack_.back()->IsString()) {
-    auto key = nodes_stack_.back().release()->AsString();
+    auto key = nodes_stack_.back()->AsString();
     nodes_stack_.pop_back();
     auto &dict = const_cast<Dict &>(nodes_stack_.back()->AsMap());
     dict.emplace(std::move(key), std::move(node));
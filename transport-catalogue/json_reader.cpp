@@ -1,6 +1,8 @@
 #include "json_reader.h"
 #include "json_builder.h"
 
+#include <iterator>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -17,20 +19,30 @@ using namespace serialization;
 JsonReader::JsonReader(transport_catalogue::TransportCatalogue &transport_catalogue)
     : transport_catalogue_(transport_catalogue) {}
 
+// Документ разбирается в плоском виде, узлы json::Node строятся только для нужных разделов
 ParsedBaseRequests JsonReader::GetParsedBaseRequests(istream &input) {
-  const auto json_input = Load(input).GetRoot();
-  const auto &base_requests = json_input.AsMap().at("base_requests"s).AsArray();
-  const auto &render_settings = json_input.AsMap().at("render_settings"s).AsMap();
-  const auto &routing_settings = json_input.AsMap().at("routing_settings"s).AsMap();
-  const auto &serialization_settings = json_input.AsMap().at("serialization_settings"s).AsMap();
-  return {base_requests, render_settings, routing_settings, serialization_settings};
+  const FlatDocument document(string{istreambuf_iterator<char>(input), istreambuf_iterator<char>()});
+  const auto root = document.GetRoot();
+  return {root.At("base_requests"sv).ToNode().AsArray(),
+          root.At("render_settings"sv).ToNode().AsMap(),
+          root.At("routing_settings"sv).ToNode().AsMap(),
+          root.At("serialization_settings"sv).ToNode().AsMap()};
 }
 
 ParsedStatRequests JsonReader::GetParsedStatRequests(istream &input) {
-  const auto json_input = Load(input).GetRoot();
-  const auto &stat_requests = json_input.AsMap().at("stat_requests"s).AsArray();
-  const auto &serialization_settings = json_input.AsMap().at("serialization_settings"s).AsMap();
-  return {stat_requests, serialization_settings};
+  const FlatDocument document(string{istreambuf_iterator<char>(input), istreambuf_iterator<char>()});
+  const auto root = document.GetRoot();
+  return {root.At("stat_requests"sv).ToNode().AsArray(),
+          root.At("serialization_settings"sv).ToNode().AsMap()};
+}
+
+StatRequests JsonReader::ReadStatRequests(istream &input) {
+  const FlatDocument document(string{istreambuf_iterator<char>(input), istreambuf_iterator<char>()});
+  const auto root = document.GetRoot();
+  const auto execution_settings = root.Find("execution_settings"sv);
+  return {GetTransportCatalogueRequests(root.At("stat_requests"sv)),
+          root.At("serialization_settings"sv).ToNode().AsMap(),
+          execution_settings ? execution_settings->ToNode().AsMap() : Dict{}};
 }
 
 Bus JsonReader::ParseBusInput(const Dict &request) {
@@ -81,6 +93,148 @@ void JsonReader::AddTransportCatalogueData(const Array &requests) {
   }
 }
 
+// Словари настроек и каждый запрос из base_requests собираются в отдельные узлы,
+// остальные элементы документа пропускаются. Остановки добавляются в каталог сразу,
+// а расстояния и автобусы - в конце, так как они могут ссылаться на ещё не прочитанные остановки
+class JsonReader::BaseRequestsHandler final : public Handler {
+ public:
+  explicit BaseRequestsHandler(JsonReader &json_reader) : json_reader_(json_reader) {}
+
+  void StartDict() override {
+    StartNode();
+    if (builder_) {
+      builder_->StartDict();
+    }
+  }
+
+  void Key(string key) override {
+    if (builder_) {
+      builder_->Key(std::move(key));
+    } else if (depth_ == 1) {
+      section_ = std::move(key);
+    }
+  }
+
+  void EndDict() override {
+    if (builder_) {
+      builder_->EndDict();
+    }
+    EndNode();
+  }
+
+  void StartArray() override {
+    StartNode();
+    if (builder_) {
+      builder_->StartArray();
+    }
+  }
+
+  void EndArray() override {
+    if (builder_) {
+      builder_->EndArray();
+    }
+    EndNode();
+  }
+
+  void Value(Node value) override {
+    if (builder_) {
+      builder_->Value(std::move(value));
+    }
+  }
+
+  ParsedBaseSettings Finish() {
+    auto &catalogue = json_reader_.transport_catalogue_;
+    for (const auto &distance : distances_) {
+      catalogue.AddDistance(distance);
+    }
+    for (auto &[bus, stops] : buses_) {
+      bus.stops_on_route.assign(stops.begin(), stops.end());
+      catalogue.AddBus(std::move(bus));
+    }
+    return std::move(settings_);
+  }
+
+ private:
+  JsonReader &json_reader_;
+  int depth_ = 0;
+  string section_;
+  optional<Builder> builder_;
+  ParsedBaseSettings settings_;
+  vector<StopsDistance> distances_;
+  // Имена остановок автобуса хранятся отдельно, пока stops_on_route ссылается на них
+  vector<pair<Bus, vector<string>>> buses_;
+
+  void StartNode() {
+    ++depth_;
+    const bool is_settings = depth_ == 2 && GetSettings() != nullptr;
+    const bool is_base_request = depth_ == 3 && section_ == "base_requests"sv;
+    if (!builder_ && (is_settings || is_base_request)) {
+      builder_.emplace();
+    }
+  }
+
+  void EndNode() {
+    --depth_;
+    if (!builder_ || depth_ > 2 || (depth_ == 2 && section_ != "base_requests"sv)) {
+      return;
+    }
+    const auto node = std::move(builder_->Build());
+    builder_.reset();
+    if (depth_ == 2) {
+      AddBaseRequest(node.AsMap());
+    } else {
+      *GetSettings() = node.AsMap();
+    }
+  }
+
+  map<string, Node> *GetSettings() {
+    if (section_ == "render_settings"sv) {
+      return &settings_.render_settings;
+    }
+    if (section_ == "routing_settings"sv) {
+      return &settings_.routing_settings;
+    }
+    if (section_ == "serialization_settings"sv) {
+      return &settings_.serialization_settings;
+    }
+    return nullptr;
+  }
+
+  void AddBaseRequest(const Dict &request) {
+    if (request.at("type"s) == BUS) {
+      const auto &stops = request.at("stops"s).AsArray();
+      vector<string> stop_names;
+      stop_names.reserve(stops.size());
+      for (const auto &stop : stops) {
+        stop_names.push_back(stop.AsString());
+      }
+      Bus bus;
+      bus.name = request.at("name"s).AsString();
+      bus.route_type = request.at("is_roundtrip"s).AsBool() ? RouteType::CIRCULAR : RouteType::LINEAR;
+      buses_.emplace_back(std::move(bus), std::move(stop_names));
+    } else if (request.at("type"s) == STOP) {
+      json_reader_.transport_catalogue_.AddStop(ParseStopInput(request));
+      for (const auto &[key, value] : request.at("road_distances"s).AsMap()) {
+        distances_.push_back({request.at("name"s).AsString(), key, value.AsInt()});
+      }
+    }
+  }
+};
+
+ParsedBaseSettings JsonReader::ReadBaseRequests(istream &input) {
+  BaseRequestsHandler handler(*this);
+  Parse(input, handler);
+  return handler.Finish();
+}
+
+Node JsonReader::SetRequestId(Node answer, int id) {
+  if (!answer.IsMap()) {
+    throw logic_error("Answer is not a dict"s);
+  }
+  get<Dict>(answer.GetValue())["request_id"s] = id;
+  return answer;
+}
+
 Node JsonReader::GetErrorJson(int id) {
   return Builder{}
       .StartDict()
@@ -175,6 +329,73 @@ Node JsonReader::GetRouteStatJson(int id, const optional<RouteData> &route_info)
   return route_info ? GetRouteStatJson(id, *route_info) : GetErrorJson(id);
 }
 
+Node JsonReader::GetRoutesFromStopJson(int id, const optional<QuerySnapshot::StopRoutes> &routes, bool with_items) {
+  if (!routes) {
+    return GetErrorJson(id);
+  }
+  Builder json_builder;
+  json_builder.StartDict().Key("request_id"s).Value(id).Key("routes"s).StartArray();
+  for (const auto &[stop_name, route] : *routes) {
+    json_builder.StartDict()
+        .Key("stop"s).Value(string(stop_name))
+        .Key("total_time"s).Value(route.total_time);
+    if (with_items) {
+      json_builder.Key("items"s).Value(GetRouteItems(route.items));
+    }
+    json_builder.EndDict();
+  }
+  json_builder.EndArray().EndDict();
+  return json_builder.Build();
+}
+
+Node JsonReader::GetIsochroneJson(int id,
+                                  const optional<QuerySnapshot::ReachableStops> &stops,
+                                  const optional<string> &map) {
+  if (!stops) {
+    return GetErrorJson(id);
+  }
+  Builder json_builder;
+  json_builder.StartDict().Key("request_id"s).Value(id).Key("stops"s).StartArray();
+  for (const auto &[stop_name, time] : *stops) {
+    json_builder.StartDict()
+        .Key("stop"s).Value(string(stop_name))
+        .Key("time"s).Value(time)
+        .EndDict();
+  }
+  json_builder.EndArray();
+  if (map) {
+    json_builder.Key("map"s).Value(*map);
+  }
+  json_builder.EndDict();
+  return json_builder.Build();
+}
+
+Node JsonReader::GetRouteMatrixJson(int id, const vector<vector<optional<RouteData>>> &routes, bool with_items) {
+  Builder json_builder;
+  json_builder.StartDict().Key("request_id"s).Value(id).Key("total_times"s).StartArray();
+  for (const auto &row : routes) {
+    json_builder.StartArray();
+    for (const auto &route : row) {
+      json_builder.Value(route ? Node(route->total_time) : Node(nullptr));
+    }
+    json_builder.EndArray();
+  }
+  json_builder.EndArray();
+  if (with_items) {
+    json_builder.Key("items"s).StartArray();
+    for (const auto &row : routes) {
+      json_builder.StartArray();
+      for (const auto &route : row) {
+        json_builder.Value(route ? GetRouteItems(route->items) : Node(nullptr));
+      }
+      json_builder.EndArray();
+    }
+    json_builder.EndArray();
+  }
+  json_builder.EndDict();
+  return json_builder.Build();
+}
+
 vector<Request> JsonReader::GetTransportCatalogueRequests(const Array &requests) {
   vector<Request> result;
   result.reserve(requests.size());
@@ -192,11 +413,91 @@ vector<Request> JsonReader::GetTransportCatalogueRequests(const Array &requests)
     if (request_map.find("to"s) != request_map.end()) {
       req.to = request_map.at("to"s).AsString();
     }
+    if (request_map.find("stops"s) != request_map.end()) {
+      for (const auto &stop : request_map.at("stops"s).AsArray()) {
+        req.stops.push_back(stop.AsString());
+      }
+    }
+    if (request_map.find("targets"s) != request_map.end()) {
+      for (const auto &stop : request_map.at("targets"s).AsArray()) {
+        req.targets.push_back(stop.AsString());
+      }
+    }
+    if (request_map.find("with_items"s) != request_map.end()) {
+      req.with_items = request_map.at("with_items"s).AsBool();
+    }
+    if (request_map.find("max_time"s) != request_map.end()) {
+      req.max_time = request_map.at("max_time"s).AsDouble();
+    }
+    if (request_map.find("render_map"s) != request_map.end()) {
+      req.render_map = request_map.at("render_map"s).AsBool();
+    }
     result.push_back(req);
   }
   return result;
 }
 
+vector<Request> JsonReader::GetTransportCatalogueRequests(FlatDocument::NodeRef requests) {
+  vector<Request> result;
+  result.reserve(requests.GetSize());
+  requests.ForEachItem([&result](FlatDocument::NodeRef request) {
+    result.push_back(GetTransportCatalogueRequest(request));
+  });
+  return result;
+}
+
+Request JsonReader::GetTransportCatalogueRequest(FlatDocument::NodeRef request) {
+  Request req;
+  req.id = request.At("id"sv).AsInt();
+  req.type = request.At("type"sv).AsString();
+  if (const auto name = request.Find("name"sv)) {
+    req.name = name->AsString();
+  }
+  if (const auto from = request.Find("from"sv)) {
+    req.from = from->AsString();
+  }
+  if (const auto to = request.Find("to"sv)) {
+    req.to = to->AsString();
+  }
+  if (const auto stops = request.Find("stops"sv)) {
+    stops->ForEachItem([&req](FlatDocument::NodeRef stop) {
+      req.stops.emplace_back(stop.AsString());
+    });
+  }
+  if (const auto targets = request.Find("targets"sv)) {
+    targets->ForEachItem([&req](FlatDocument::NodeRef stop) {
+      req.targets.emplace_back(stop.AsString());
+    });
+  }
+  if (const auto with_items = request.Find("with_items"sv)) {
+    req.with_items = with_items->AsBool();
+  }
+  if (const auto max_time = request.Find("max_time"sv)) {
+    req.max_time = max_time->AsDouble();
+  }
+  if (const auto render_map = request.Find("render_map"sv)) {
+    req.render_map = render_map->AsBool();
+  }
+  return req;
+}
+
+StatRequests JsonReader::ReadServeSettings(string_view settings) {
+  const FlatDocument document{string(settings)};
+  const auto root = document.GetRoot();
+  const auto execution_settings = root.Find("execution_settings"sv);
+  return {{},
+          root.At("serialization_settings"sv).ToNode().AsMap(),
+          execution_settings ? execution_settings->ToNode().AsMap() : Dict{}};
+}
+
+Node JsonReader::GetInvalidRequestJson(const string &message, optional<int> id) {
+  Dict result{{"error_message"s, message}};
+  if (id) {
+    result.emplace("request_id"s, *id);
+  }
+  return result;
+}
+
 Point JsonReader::GetOffset(const Array &offset) {
   return {offset[0].AsDouble(), offset[1].AsDouble()};
 }
@@ -244,13 +545,81 @@ renderer::RenderSettings JsonReader::GetMapSettings(const Dict &request) {
   return settings;
 }
 
+RouterType JsonReader::GetRouterType(const Dict &requests) {
+  const auto it = requests.find("router"s);
+  if (it == requests.end() || it->second.AsString() == "dijkstra"s) {
+    return RouterType::DIJKSTRA;
+  }
+  if (it->second.AsString() == "all_pairs"s) {
+    return RouterType::ALL_PAIRS;
+  }
+  if (it->second.AsString() == "contraction_hierarchy"s) {
+    return RouterType::CONTRACTION_HIERARCHY;
+  }
+  throw invalid_argument("Unknown router type: "s + it->second.AsString());
+}
+
+GraphModel JsonReader::GetGraphModel(const Dict &requests) {
+  const auto it = requests.find("graph_model"s);
+  if (it == requests.end() || it->second.AsString() == "stop_pairs"s) {
+    return GraphModel::STOP_PAIRS;
+  }
+  if (it->second.AsString() == "ride_vertices"s) {
+    return GraphModel::RIDE_VERTICES;
+  }
+  throw invalid_argument("Unknown graph model: "s + it->second.AsString());
+}
+
 RoutingSettings JsonReader::GetRoutingSettings(const Dict &requests) {
   return {requests.at("bus_velocity"s).AsDouble(),
-          requests.at("bus_wait_time"s).AsInt()};
+          requests.at("bus_wait_time"s).AsInt(),
+          GetRouterType(requests),
+          GetGraphModel(requests)};
+}
+
+ExecutionSettings JsonReader::GetExecutionSettings(const Dict &requests) {
+  ExecutionSettings settings;
+  if (const auto it = requests.find("mode"s); it != requests.end()) {
+    if (it->second.AsString() == "parallel"s) {
+      settings.mode = ExecutionMode::PARALLEL;
+    } else if (it->second.AsString() != "sequential"s) {
+      throw invalid_argument("Unknown execution mode: "s + it->second.AsString());
+    }
+  }
+  if (const auto it = requests.find("thread_count"s); it != requests.end()) {
+    if (it->second.AsInt() < 0) {
+      throw invalid_argument("Thread count must be non-negative"s);
+    }
+    settings.thread_count = static_cast<size_t>(it->second.AsInt());
+  }
+  if (const auto it = requests.find("route_cache_size"s); it != requests.end()) {
+    if (it->second.AsInt() < 0) {
+      throw invalid_argument("Route cache size must be non-negative"s);
+    }
+    settings.route_cache_size = static_cast<size_t>(it->second.AsInt());
+  }
+  if (const auto it = requests.find("profile_output"s); it != requests.end()) {
+    settings.profile_output = it->second.AsString();
+  }
+  return settings;
+}
+
+DatabaseFormat JsonReader::GetDatabaseFormat(const Dict &requests) {
+  const auto it = requests.find("format"s);
+  if (it == requests.end() || it->second.AsString() == "protobuf"s) {
+    return DatabaseFormat::PROTOBUF;
+  }
+  if (it->second.AsString() == "flat"s) {
+    return DatabaseFormat::FLAT;
+  }
+  throw invalid_argument("Unknown database format: "s + it->second.AsString());
 }
 
 SerializationSettings JsonReader::GetSerializationSettings(const Dict &requests) {
-  return {requests.at("file"s).AsString()};
+  const auto prerender_map = requests.find("prerender_map"s);
+  return {requests.at("file"s).AsString(),
+          GetDatabaseFormat(requests),
+          prerender_map != requests.end() && prerender_map->second.AsBool()};
 }
 
 }
\ No newline at end of file
@@ -21,6 +21,14 @@ struct Request {
   std::string name;
   std::string from;
   std::string to;
+  // Остановки отправления и назначения запроса RouteMatrix
+  std::vector<std::string> stops;
+  std::vector<std::string> targets;
+  // Ответы RouteFromStop и RouteMatrix содержат только время, если участки маршрута не запрошены
+  bool with_items = false;
+  // Время в пути в минутах и карта с выделенными остановками для запроса Isochrone
+  double max_time = 0.;
+  bool render_map = false;
 };
 
 //struct ParsedRequests {
@@ -38,11 +46,24 @@ struct ParsedBaseRequests {
   std::map<std::string, json::Node> serialization_settings;
 };
 
+struct ParsedBaseSettings {
+  std::map<std::string, json::Node> render_settings;
+  std::map<std::string, json::Node> routing_settings;
+  std::map<std::string, json::Node> serialization_settings;
+};
+
 struct ParsedStatRequests {
   std::vector<json::Node> stat_requests;
   std::map<std::string, json::Node> serialization_settings;
 };
 
+struct StatRequests {
+  std::vector<Request> requests;
+  std::map<std::string, json::Node> serialization_settings;
+  // Пустой словарь, если раздел execution_settings не задан
+  std::map<std::string, json::Node> execution_settings;
+};
+
 class JsonReader {
  public:
   explicit JsonReader(transport_catalogue::TransportCatalogue &transport_catalogue);
@@ -53,8 +74,15 @@ class JsonReader {
 
   static ParsedStatRequests GetParsedStatRequests(std::istream &input);
 
+  // Разбирает запрос process_requests в плоский документ, узлы json::Node строятся только для настроек
+  static StatRequests ReadStatRequests(std::istream &input);
+
   void AddTransportCatalogueData(const json::Array &requests);
 
+  // Потоковый разбор запроса make_base: данные из base_requests добавляются в каталог по мере чтения,
+  // дерево документа целиком не строится
+  ParsedBaseSettings ReadBaseRequests(std::istream &input);
+
   static json::Node GetBusStatJson(int id,
                                    const std::optional<transport_catalogue::detail::RouteStat> &route_stat);
 
@@ -65,22 +93,56 @@ class JsonReader {
 
   static std::vector<Request> GetTransportCatalogueRequests(const json::Array &requests);
 
+  static std::vector<Request> GetTransportCatalogueRequests(json::FlatDocument::NodeRef requests);
+
+  static Request GetTransportCatalogueRequest(json::FlatDocument::NodeRef request);
+
+  // Настройки режима serve из первой строки: {"serialization_settings": {...}, "execution_settings": {...}},
+  // список запросов в результате пуст
+  static StatRequests ReadServeSettings(std::string_view settings);
+
+  // Ответ на запрос, который не удалось выполнить в режиме serve
+  static json::Node GetInvalidRequestJson(const std::string &message, std::optional<int> id = std::nullopt);
+
   static renderer::RenderSettings GetMapSettings(const json::Dict &request);
 
   static routing::RoutingSettings GetRoutingSettings(const json::Dict &requests);
 
   static serialization::SerializationSettings GetSerializationSettings(const json::Dict &requests);
 
+  static ExecutionSettings GetExecutionSettings(const json::Dict &requests);
+
   static json::Node GetRouteStatJson(int id, const std::optional<routing::RouteData> &route_info);
 
+  static json::Node GetRoutesFromStopJson(int id,
+                                          const std::optional<QuerySnapshot::StopRoutes> &routes,
+                                          bool with_items);
+
+  static json::Node GetIsochroneJson(int id,
+                                     const std::optional<QuerySnapshot::ReachableStops> &stops,
+                                     const std::optional<std::string> &map);
+
+  // Строки матрицы соответствуют stops, столбцы - targets, null - маршрута нет
+  static json::Node GetRouteMatrixJson(int id,
+                                       const std::vector<std::vector<std::optional<routing::RouteData>>> &routes,
+                                       bool with_items);
+
+  // Ответ на такой же запрос с другим id
+  static json::Node SetRequestId(json::Node answer, int id);
+
   inline static const std::string BUS = "Bus"s;
   inline static const std::string STOP = "Stop"s;
   inline static const std::string MAP = "Map"s;
   inline static const std::string ROUTE = "Route"s;
+  inline static const std::string ROUTE_FROM_STOP = "RouteFromStop"s;
+  inline static const std::string ROUTE_MATRIX = "RouteMatrix"s;
+  inline static const std::string ISOCHRONE = "Isochrone"s;
 
  private:
   transport_catalogue::TransportCatalogue &transport_catalogue_;
 
+  class BaseRequestsHandler;
+
   static transport_catalogue::detail::Bus ParseBusInput(const json::Dict &request);
 
   static transport_catalogue::detail::Stop ParseStopInput(const json::Dict &request);
@@ -101,6 +163,12 @@ class JsonReader {
   static svg::Color GetColor(const json::Node &color);
 
   static std::vector<svg::Color> GetColorPalette(const json::Array &colors);
+
+  static routing::RouterType GetRouterType(const json::Dict &requests);
+
+  static routing::GraphModel GetGraphModel(const json::Dict &requests);
+
+  static serialization::DatabaseFormat GetDatabaseFormat(const json::Dict &requests);
 };
 
 }
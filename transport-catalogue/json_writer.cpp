@@ -0,0 +1,96 @@
+#include "json_writer.h"
+
+using namespace std;
+
+namespace json {
+
+Writer::Writer(ostream &out, int indent_step)
+    : out_(out), indent_step_(indent_step) {}
+
+PrintContext Writer::GetContext() const {
+  return {out_, indent_step_, indent_step_ * static_cast<int>(levels_.size())};
+}
+
+void Writer::StartValue() {
+  if (levels_.empty()) {
+    if (is_root_written_) {
+      throw logic_error("Invalid value after root"s);
+    }
+    is_root_written_ = true;
+    return;
+  }
+  auto &level = levels_.back();
+  if (level.is_dict) {
+    if (!level.has_key) {
+      throw logic_error("Invalid value without key"s);
+    }
+    level.has_key = false;
+    return;
+  }
+  if (!level.is_empty) {
+    out_ << ",\n"sv;
+  }
+  level.is_empty = false;
+  GetContext().PrintIndent();
+}
+
+Writer &Writer::StartArray() {
+  StartValue();
+  out_ << "[\n"sv;
+  levels_.push_back({false});
+  return *this;
+}
+
+Writer &Writer::StartDict() {
+  StartValue();
+  out_ << "{\n"sv;
+  levels_.push_back({true});
+  return *this;
+}
+
+Writer &Writer::EndArray() {
+  if (levels_.empty() || levels_.back().is_dict) {
+    throw logic_error("Invalid array end"s);
+  }
+  levels_.pop_back();
+  out_ << "\n"sv;
+  GetContext().PrintIndent();
+  out_ << "]"sv;
+  return *this;
+}
+
+Writer &Writer::EndDict() {
+  if (levels_.empty() || !levels_.back().is_dict || levels_.back().has_key) {
+    throw logic_error("Invalid dict end"s);
+  }
+  levels_.pop_back();
+  out_ << "\n"sv;
+  GetContext().PrintIndent();
+  out_ << "}"sv;
+  return *this;
+}
+
+Writer &Writer::Key(string_view key) {
+  if (levels_.empty() || !levels_.back().is_dict || levels_.back().has_key) {
+    throw logic_error("Invalid key assign"s);
+  }
+  auto &level = levels_.back();
+  if (!level.is_empty) {
+    out_ << ",\n"sv;
+  }
+  level.is_empty = false;
+  level.has_key = true;
+  const auto ctx = GetContext();
+  ctx.PrintIndent();
+  PrintValue(string(key), ctx);
+  out_ << ": "sv;
+  return *this;
+}
+
+Writer &Writer::Value(const Node &value) {
+  StartValue();
+  PrintNode(value, GetContext());
+  return *this;
+}
+
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "json.h"
+
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+namespace json {
+
+// Пишет JSON прямо в поток по мере поступления элементов в том же формате, что и Print.
+// Ключи словаря выводятся в порядке вызова Key, поэтому для совпадения с Print их нужно
+// передавать отсортированными. Узлы, переданные в Value, печатаются целиком через PrintNode
+class Writer {
+ public:
+  explicit Writer(std::ostream &out, int indent_step = 4);
+
+  Writer &StartArray();
+  Writer &EndArray();
+  Writer &StartDict();
+  Writer &EndDict();
+  Writer &Key(std::string_view key);
+  Writer &Value(const Node &value);
+
+ private:
+  struct Level {
+    bool is_dict = false;
+    bool is_empty = true;
+    bool has_key = false;
+  };
+
+  std::ostream &out_;
+  int indent_step_;
+  std::vector<Level> levels_;
+  bool is_root_written_ = false;
+
+  void StartValue();
+  [[nodiscard]] PrintContext GetContext() const;
+};
+
+}
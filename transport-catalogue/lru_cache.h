@@ -0,0 +1,151 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace concurrency {
+
+// Ограниченный по размеру кэш с вытеснением давно не использованных элементов.
+// Ключи распределены по сегментам с отдельными мьютексами, поэтому потоки,
+// обращающиеся к разным ключам, редко ждут друг друга. Ёмкость делится между сегментами
+// с округлением вверх, ёмкость 0 отключает кэш
+template<typename Key, typename Value, typename Hash = std::hash<Key>>
+class LruCache {
+ public:
+  struct Stats {
+    size_t hits = 0;
+    size_t misses = 0;
+  };
+
+  static const size_t DEFAULT_SHARD_COUNT = 16;
+
+  explicit LruCache(size_t capacity, size_t shard_count = DEFAULT_SHARD_COUNT);
+
+  LruCache(const LruCache &) = delete;
+  LruCache &operator=(const LruCache &) = delete;
+
+  // Найденный элемент становится последним использованным
+  std::optional<Value> Find(const Key &key);
+
+  void Insert(const Key &key, Value value);
+
+  // Значение вычисляется вне блокировки, поэтому при одновременном промахе
+  // по одному ключу его могут вычислить несколько потоков
+  template<typename Compute>
+  Value GetOrCompute(const Key &key, Compute compute);
+
+  [[nodiscard]] Stats GetStats() const;
+
+  [[nodiscard]] size_t GetCapacity() const;
+
+  [[nodiscard]] size_t GetSize() const;
+
+ private:
+  using Items = std::list<std::pair<Key, Value>>;
+
+  struct Shard {
+    mutable std::mutex mutex;
+    // В начале списка - последние использованные элементы
+    Items items;
+    std::unordered_map<Key, typename Items::iterator, Hash> index;
+  };
+
+  size_t capacity_;
+  size_t shard_capacity_;
+  std::vector<Shard> shards_;
+  Hash hash_;
+  std::atomic<size_t> hits_{0};
+  std::atomic<size_t> misses_{0};
+
+  Shard &GetShard(const Key &key);
+};
+
+template<typename Key, typename Value, typename Hash>
+LruCache<Key, Value, Hash>::LruCache(size_t capacity, size_t shard_count)
+    : capacity_(capacity),
+      shards_(std::max<size_t>(1, std::min(capacity, shard_count))) {
+  shard_capacity_ = (capacity_ + shards_.size() - 1) / shards_.size();
+}
+
+template<typename Key, typename Value, typename Hash>
+std::optional<Value> LruCache<Key, Value, Hash>::Find(const Key &key) {
+  if (capacity_ == 0) {
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    return std::nullopt;
+  }
+  auto &shard = GetShard(key);
+  std::lock_guard guard(shard.mutex);
+  const auto it = shard.index.find(key);
+  if (it == shard.index.end()) {
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    return std::nullopt;
+  }
+  hits_.fetch_add(1, std::memory_order_relaxed);
+  shard.items.splice(shard.items.begin(), shard.items, it->second);
+  return it->second->second;
+}
+
+template<typename Key, typename Value, typename Hash>
+void LruCache<Key, Value, Hash>::Insert(const Key &key, Value value) {
+  if (capacity_ == 0) {
+    return;
+  }
+  auto &shard = GetShard(key);
+  std::lock_guard guard(shard.mutex);
+  if (const auto it = shard.index.find(key); it != shard.index.end()) {
+    it->second->second = std::move(value);
+    shard.items.splice(shard.items.begin(), shard.items, it->second);
+    return;
+  }
+  shard.items.emplace_front(key, std::move(value));
+  shard.index.emplace(key, shard.items.begin());
+  if (shard.items.size() > shard_capacity_) {
+    shard.index.erase(shard.items.back().first);
+    shard.items.pop_back();
+  }
+}
+
+template<typename Key, typename Value, typename Hash>
+template<typename Compute>
+Value LruCache<Key, Value, Hash>::GetOrCompute(const Key &key, Compute compute) {
+  if (auto value = Find(key)) {
+    return std::move(*value);
+  }
+  Value value = compute();
+  Insert(key, value);
+  return value;
+}
+
+template<typename Key, typename Value, typename Hash>
+typename LruCache<Key, Value, Hash>::Stats LruCache<Key, Value, Hash>::GetStats() const {
+  return {hits_.load(std::memory_order_relaxed), misses_.load(std::memory_order_relaxed)};
+}
+
+template<typename Key, typename Value, typename Hash>
+size_t LruCache<Key, Value, Hash>::GetCapacity() const {
+  return capacity_;
+}
+
+template<typename Key, typename Value, typename Hash>
+size_t LruCache<Key, Value, Hash>::GetSize() const {
+  size_t size = 0;
+  for (const auto &shard : shards_) {
+    std::lock_guard guard(shard.mutex);
+    size += shard.items.size();
+  }
+  return size;
+}
+
+template<typename Key, typename Value, typename Hash>
+typename LruCache<Key, Value, Hash>::Shard &LruCache<Key, Value, Hash>::GetShard(const Key &key) {
+  return shards_[hash_(key) % shards_.size()];
+}
+
+}
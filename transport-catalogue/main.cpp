@@ -4,36 +4,54 @@
 #include <fstream>
 
 #ifdef TEST_MODE
+void CityGeneratorRunTest();
+void ContractionHierarchyRouterRunTest();
+void DijkstraRouterRunTest();
+void DistanceMatrixRunTest();
+void FlatSerializationRunTest();
 void GeoRunTest();
 void GraphRunTest();
 void InputReaderRunTest();
 void JsonRunTest();
 void JsonBuilderRunTest();
 void JsonReaderRunTest();
+void JsonWriterRunTest();
+void LruCacheRunTest();
 void MapRendererRunTest();
+void ProfilerRunTest();
 void RangesRunTest();
 void RequestHandlerRunTest();
 void RouterRunTest();
 void SerializationRunTest();
 void StatReaderRunTest();
 void SvgRunTest();
+void ThreadPoolRunTest();
 void TransportCatalogueRunTest();
 void TransportRouterRunTest();
 
 void runTests() {
+  CityGeneratorRunTest();
+  ContractionHierarchyRouterRunTest();
+  DijkstraRouterRunTest();
+  DistanceMatrixRunTest();
+  FlatSerializationRunTest();
   GeoRunTest();
   GraphRunTest();
   InputReaderRunTest();
   JsonRunTest();
   JsonBuilderRunTest();
   JsonReaderRunTest();
+  JsonWriterRunTest();
+  LruCacheRunTest();
   MapRendererRunTest();
+  ProfilerRunTest();
   RangesRunTest();
   RequestHandlerRunTest();
   RouterRunTest();
   SerializationRunTest();
   StatReaderRunTest();
   SvgRunTest();
+  ThreadPoolRunTest();
   TransportCatalogueRunTest();
   TransportRouterRunTest();
 }
@@ -42,7 +60,7 @@ void runTests() {
 using namespace std;
 
 void PrintUsage(std::ostream &stream = std::cerr) {
-  stream << "Usage: transport_catalogue [make_base|process_requests]\n"sv;
+  stream << "Usage: transport_catalogue [make_base|process_requests|serve]\n"sv;
 }
 
 int main(int argc, char *argv[]) {
@@ -69,6 +87,8 @@ int main(int argc, char *argv[]) {
 //    std::ofstream out("answer.txt");
 //    request_handler.ProcessRequests(in, out);
     request_handler.ProcessRequests(cin, cout);
+  } else if (mode == "serve"sv) {
+    request_handler.Serve(cin, cout);
   } else {
     PrintUsage();
     return 1;
@@ -1,6 +1,7 @@
 #include "map_renderer.h"
 
 #include <cassert>
+#include <numeric>
 #include <sstream>
 
 using namespace std;
@@ -120,10 +121,10 @@ const std::vector<svg::Color> &RenderSettings::GetColorPalette() const {
 
 MapRenderer::MapRenderer(RenderSettings settings) : settings_(std::move(settings)) {}
 
-vector<Coordinates> MapRenderer::GetStopCoords(const unordered_map<string_view, shared_ptr<Stop>> &stops) {
+vector<Coordinates> MapRenderer::GetStopCoords(const StopVector &stops) {
   vector<Coordinates> stop_coords;
   stop_coords.reserve(stops.size());
-  for (const auto &[_, stop] : stops) {
+  for (const auto &stop : stops) {
     if (!stop->buses_through_stop.empty()) {
       stop_coords.emplace_back(stop->coordinates);
     }
@@ -131,44 +132,59 @@ vector<Coordinates> MapRenderer::GetStopCoords(const unordered_map<string_view,
   return stop_coords;
 }
 
-vector<string_view> MapRenderer::GetStopNames(const unordered_map<string_view, shared_ptr<Stop>> &stops) {
-  return GetSortedUnorderedMapKeys(stops);
+vector<StopId> MapRenderer::GetSortedStopIds(const StopVector &stops) {
+  vector<StopId> stop_ids(stops.size());
+  iota(stop_ids.begin(), stop_ids.end(), StopId{0});
+  sort(stop_ids.begin(), stop_ids.end(), [&stops](StopId lhs, StopId rhs) {
+    return stops[lhs]->name < stops[rhs]->name;
+  });
+  return stop_ids;
 }
 
-Document MapRenderer::RenderMap(const vector<shared_ptr<Bus>> &buses,
-                                const unordered_map<string_view, shared_ptr<Stop>> &stops) const {
+Document MapRenderer::RenderMap(const BusVector &buses,
+                                const StopVector &stops,
+                                const vector<StopId> &highlighted_stops) const {
   Document document;
-  const auto &stop_names = GetStopNames(stops);
+  const auto &stop_ids = GetSortedStopIds(stops);
   const auto &stop_coords = GetStopCoords(stops);
   SphereProjector sphere_projector{stop_coords.begin(), stop_coords.end(),
                                    settings_.width, settings_.height, settings_.padding};
 
   RenderBusLines(document, sphere_projector, buses, stops);
   RenderBusNames(document, sphere_projector, buses, stops);
-  RenderStopCircles(document, sphere_projector, stops, stop_names);
-  RenderStopNames(document, sphere_projector, stops, stop_names);
+  RenderStopHighlights(document, sphere_projector, stops, highlighted_stops);
+  RenderStopCircles(document, sphere_projector, stops, stop_ids);
+  RenderStopNames(document, sphere_projector, stops, stop_ids);
 
   return document;
 }
 
+string MapRenderer::RenderMapToString(const BusVector &buses,
+                                      const StopVector &stops,
+                                      const vector<StopId> &highlighted_stops) const {
+  ostringstream buffer;
+  RenderMap(buses, stops, highlighted_stops).Render(buffer);
+  return buffer.str();
+}
+
 void MapRenderer::RenderBusLines(Document &document,
                                  const SphereProjector &sphere_projector,
-                                 const vector<shared_ptr<Bus>> &buses,
-                                 const unordered_map<string_view, shared_ptr<Stop>> &stops) const {
+                                 const BusVector &buses,
+                                 const StopVector &stops) const {
   const size_t color_size = settings_.color_palette.size();
   assert(color_size);
   size_t color_index = 0;
 
   for (const auto &bus : buses) {
-    if (!bus->stops_on_route.empty()) {
+    if (!bus->stop_ids_on_route.empty()) {
       Polyline line;
-      for (const auto stop_name : bus->stops_on_route) {
-        Point stop = sphere_projector(stops.at(stop_name)->coordinates);
+      for (const auto stop_id : bus->stop_ids_on_route) {
+        Point stop = sphere_projector(stops[stop_id]->coordinates);
         line.AddPoint(stop);
       }
       if (bus->route_type == RouteType::LINEAR) {
-        for (auto it = bus->stops_on_route.rbegin() + 1; it != bus->stops_on_route.rend(); ++it) {
-          Point stop = sphere_projector(stops.at(*it)->coordinates);
+        for (auto it = bus->stop_ids_on_route.rbegin() + 1; it != bus->stop_ids_on_route.rend(); ++it) {
+          Point stop = sphere_projector(stops[*it]->coordinates);
           line.AddPoint(stop);
         }
       }
@@ -187,24 +203,24 @@ void MapRenderer::RenderBusLines(Document &document,
 
 void MapRenderer::RenderBusNames(Document &document,
                                  const SphereProjector &sphere_projector,
-                                 const vector<shared_ptr<Bus>> &buses,
-                                 const unordered_map<string_view, shared_ptr<Stop>> &stops) const {
+                                 const BusVector &buses,
+                                 const StopVector &stops) const {
   const size_t color_size = settings_.color_palette.size();
   assert(color_size);
   size_t color_index = 0;
   for (const auto &bus : buses) {
-    vector<string_view> final_stops;
+    vector<StopId> final_stops;
     final_stops.reserve(2);
-    if (!bus->stops_on_route.empty()) {
-      final_stops.emplace_back(bus->stops_on_route.front());
+    if (!bus->stop_ids_on_route.empty()) {
+      final_stops.emplace_back(bus->stop_ids_on_route.front());
       if (bus->route_type == RouteType::LINEAR) {
-        const auto last_stop = bus->stops_on_route.back();
+        const auto last_stop = bus->stop_ids_on_route.back();
         if (final_stops[0] != last_stop) {
           final_stops.emplace_back(last_stop);
         }
       }
       for (const auto final_stop : final_stops) {
-        Point stop_point = sphere_projector(stops.at(final_stop)->coordinates);
+        Point stop_point = sphere_projector(stops[final_stop]->coordinates);
         document.Add(Text()
                          .SetData(bus->name)
                          .SetFillColor(settings_.underlayer_color)
@@ -231,12 +247,31 @@ void MapRenderer::RenderBusNames(Document &document,
   }
 }
 
+void MapRenderer::RenderStopHighlights(Document &document,
+                                       const SphereProjector &sphere_projector,
+                                       const StopVector &stops,
+                                       const vector<StopId> &highlighted_stops) const {
+  if (highlighted_stops.empty()) {
+    return;
+  }
+  assert(!settings_.color_palette.empty());
+  for (const auto stop_id : highlighted_stops) {
+    const auto &stop = stops[stop_id];
+    if (!stop->buses_through_stop.empty()) {
+      document.Add(Circle()
+                       .SetCenter(sphere_projector(stop->coordinates))
+                       .SetRadius(settings_.stop_radius * 2)
+                       .SetFillColor(settings_.color_palette.front()));
+    }
+  }
+}
+
 void MapRenderer::RenderStopCircles(Document &document,
                                     const SphereProjector &sphere_projector,
-                                    const unordered_map<string_view, shared_ptr<Stop>> &stops,
-                                    const vector<string_view> &stop_names) const {
-  for (const auto stop_name : stop_names) {
-    const auto &stop = stops.at(stop_name);
+                                    const StopVector &stops,
+                                    const vector<StopId> &stop_ids) const {
+  for (const auto stop_id : stop_ids) {
+    const auto &stop = stops[stop_id];
     if (!stop->buses_through_stop.empty()) {
       document.Add(Circle()
                        .SetCenter(sphere_projector(stop->coordinates))
@@ -248,12 +283,12 @@ void MapRenderer::RenderStopCircles(Document &document,
 
 void MapRenderer::RenderStopNames(Document &document,
                                   const SphereProjector &sphere_projector,
-                                  const unordered_map<string_view, shared_ptr<Stop>> &stops,
-                                  const vector<string_view> &stop_names) const {
-  for (const auto stop_name : stop_names) {
-    const auto &stop = stops.at(stop_name);
+                                  const StopVector &stops,
+                                  const vector<StopId> &stop_ids) const {
+  for (const auto stop_id : stop_ids) {
+    const auto &stop = stops[stop_id];
     if (!stop->buses_through_stop.empty()) {
-      Point stop_point = sphere_projector(stops.at(stop_name)->coordinates);
+      Point stop_point = sphere_projector(stop->coordinates);
       document.Add(Text()
                        .SetData(stop->name)
                        .SetFillColor(settings_.underlayer_color)
@@ -137,40 +137,55 @@ struct RenderSettings {
 
 class MapRenderer {
  public:
-  using BusVector = std::vector<std::shared_ptr<transport_catalogue::detail::Bus>>;
-  using StopMap = std::unordered_map<std::string_view,
-                                     std::shared_ptr<transport_catalogue::detail::Stop>>;
+  using BusVector = std::vector<const transport_catalogue::detail::Bus *>;
+  // Остановки, упорядоченные по StopId
+  using StopVector = std::vector<const transport_catalogue::detail::Stop *>;
 
   explicit MapRenderer(RenderSettings settings);
 
-  [[nodiscard]] svg::Document RenderMap(const BusVector &buses, const StopMap &stops) const;
+  // Остановки highlighted_stops выделяются кругом цвета первого маршрута под значком остановки
+  [[nodiscard]] svg::Document RenderMap(
+      const BusVector &buses,
+      const StopVector &stops,
+      const std::vector<transport_catalogue::detail::StopId> &highlighted_stops = {}) const;
+
+  // Карта в виде текста SVG, как в ответе на запрос Map
+  [[nodiscard]] std::string RenderMapToString(
+      const BusVector &buses,
+      const StopVector &stops,
+      const std::vector<transport_catalogue::detail::StopId> &highlighted_stops = {}) const;
 
  private:
   RenderSettings settings_;
 
-  static std::vector<geo::Coordinates> GetStopCoords(const StopMap &stops);
+  static std::vector<geo::Coordinates> GetStopCoords(const StopVector &stops);
 
-  static std::vector<std::string_view> GetStopNames(const StopMap &stops);
+  static std::vector<transport_catalogue::detail::StopId> GetSortedStopIds(const StopVector &stops);
 
   void RenderBusLines(svg::Document &document,
                       const SphereProjector &sphere_projector,
                       const BusVector &buses,
-                      const StopMap &stops) const;
+                      const StopVector &stops) const;
 
   void RenderBusNames(svg::Document &document,
                       const SphereProjector &sphere_projector,
                       const BusVector &buses,
-                      const StopMap &stops) const;
+                      const StopVector &stops) const;
+
+  void RenderStopHighlights(svg::Document &document,
+                            const SphereProjector &sphere_projector,
+                            const StopVector &stops,
+                            const std::vector<transport_catalogue::detail::StopId> &highlighted_stops) const;
 
   void RenderStopCircles(svg::Document &document,
                          const SphereProjector &sphere_projector,
-                         const StopMap &stops,
-                         const std::vector<std::string_view> &stop_names) const;
+                         const StopVector &stops,
+                         const std::vector<transport_catalogue::detail::StopId> &stop_ids) const;
 
   void RenderStopNames(svg::Document &document,
                        const SphereProjector &sphere_projector,
-                       const StopMap &stops,
-                       const std::vector<std::string_view> &stop_names) const;
+                       const StopVector &stops,
+                       const std::vector<transport_catalogue::detail::StopId> &stop_ids) const;
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,160 @@
+#include "profiler.h"
+
+#include <algorithm>
+#include <iomanip>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#define TC_HAS_RUSAGE
+#endif
+
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#include <malloc.h>
+#define TC_HAS_MALLINFO2
+#endif
+
+using namespace std;
+
+namespace profiling {
+
+namespace {
+
+double ToMilliseconds(Profiler::Clock::duration duration) {
+  return chrono::duration<double, milli>(duration).count();
+}
+
+double ToMicroseconds(Profiler::Clock::duration duration) {
+  return chrono::duration<double, micro>(duration).count();
+}
+
+}
+
+size_t GetPeakRssKb() {
+#ifdef TC_HAS_RUSAGE
+  struct rusage usage{};
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return 0;
+  }
+#ifdef __APPLE__
+  // На macOS ru_maxrss в байтах
+  return static_cast<size_t>(usage.ru_maxrss) / 1024;
+#else
+  return static_cast<size_t>(usage.ru_maxrss);
+#endif
+#else
+  return 0;
+#endif
+}
+
+size_t GetHeapInUseKb() {
+#ifdef TC_HAS_MALLINFO2
+  const auto info = mallinfo2();
+  return (info.uordblks + info.hblkhd) / 1024;
+#else
+  return 0;
+#endif
+}
+
+void Profiler::AddPhase(const string &name, Clock::duration duration) {
+  const size_t peak_rss_kb = GetPeakRssKb();
+  const size_t heap_in_use_kb = GetHeapInUseKb();
+  lock_guard guard(mutex_);
+  auto it = find_if(phases_.begin(), phases_.end(), [&name](const Phase &phase) {
+    return phase.name == name;
+  });
+  if (it == phases_.end()) {
+    it = phases_.insert(phases_.end(), Phase{name});
+  }
+  it->duration += duration;
+  ++it->calls;
+  it->peak_rss_kb = peak_rss_kb;
+  it->heap_in_use_kb = heap_in_use_kb;
+}
+
+void Profiler::AddRequest(const string &type, Clock::duration duration) {
+  lock_guard guard(mutex_);
+  auto &histogram = requests_[type];
+  ++histogram.count;
+  histogram.total += duration;
+  histogram.max = max(histogram.max, duration);
+  ++histogram.buckets[GetBucket(duration)];
+}
+
+void Profiler::SetCounter(const string &name, size_t value) {
+  lock_guard guard(mutex_);
+  counters_[name] = value;
+}
+
+vector<Profiler::Phase> Profiler::GetPhases() const {
+  lock_guard guard(mutex_);
+  return phases_;
+}
+
+map<string, Profiler::Histogram> Profiler::GetRequests() const {
+  lock_guard guard(mutex_);
+  return requests_;
+}
+
+map<string, size_t> Profiler::GetCounters() const {
+  lock_guard guard(mutex_);
+  return counters_;
+}
+
+size_t Profiler::GetBucket(Clock::duration duration) {
+  auto microseconds = chrono::duration_cast<chrono::microseconds>(duration).count();
+  size_t bucket = 0;
+  while (microseconds > 0 && bucket + 1 < BUCKET_COUNT) {
+    microseconds >>= 1;
+    ++bucket;
+  }
+  return bucket;
+}
+
+void Profiler::Report(ostream &out) const {
+  lock_guard guard(mutex_);
+  const auto flags = out.flags();
+  out << fixed << setprecision(3);
+  out << "phase"sv << setw(27) << "time_ms"sv << setw(8) << "calls"sv
+      << setw(14) << "peak_rss_kb"sv << setw(14) << "heap_kb"sv << '\n';
+  for (const auto &phase : phases_) {
+    out << left << setw(24) << phase.name << right
+        << setw(8) << ToMilliseconds(phase.duration)
+        << setw(8) << phase.calls
+        << setw(14) << phase.peak_rss_kb
+        << setw(14) << phase.heap_in_use_kb << '\n';
+  }
+  for (const auto &[type, histogram] : requests_) {
+    out << "request "sv << type
+        << ": count "sv << histogram.count
+        << ", total_ms "sv << ToMilliseconds(histogram.total)
+        << ", mean_us "sv << ToMicroseconds(histogram.total) / static_cast<double>(histogram.count)
+        << ", max_us "sv << ToMicroseconds(histogram.max) << '\n';
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+      if (histogram.buckets[i] == 0) {
+        continue;
+      }
+      out << "  "sv;
+      if (i == 0) {
+        out << "<1us"sv;
+      } else {
+        out << (1ull << (i - 1)) << '-' << (1ull << i) << "us"sv;
+      }
+      out << ": "sv << histogram.buckets[i] << '\n';
+    }
+  }
+  for (const auto &[name, value] : counters_) {
+    out << "counter "sv << name << ": "sv << value << '\n';
+  }
+  out.flags(flags);
+}
+
+ScopedTimer::ScopedTimer(Profiler *profiler, string phase)
+    : profiler_(profiler), phase_(std::move(phase)), start_(profiler ? Profiler::Clock::now() : Profiler::Clock::time_point{}) {}
+
+ScopedTimer::~ScopedTimer() {
+  if (profiler_) {
+    profiler_->AddPhase(phase_, Profiler::Clock::now() - start_);
+  }
+}
+
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace profiling {
+
+// Пиковый размер резидентной памяти процесса в килобайтах, 0 - если система его не сообщает
+size_t GetPeakRssKb();
+
+// Память, занятая выделенными блоками кучи, в килобайтах, 0 - если аллокатор её не сообщает
+size_t GetHeapInUseKb();
+
+// Время этапов обработки и гистограммы времени ответа по типам запросов.
+// Запросы можно добавлять из нескольких потоков
+class Profiler {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  // Корзина i гистограммы - время от 2^(i-1) до 2^i мкс, корзина 0 - меньше 1 мкс
+  static const size_t BUCKET_COUNT = 24;
+
+  struct Phase {
+    std::string name;
+    Clock::duration duration{};
+    size_t calls = 0;
+    // Память после последнего вызова этапа
+    size_t peak_rss_kb = 0;
+    size_t heap_in_use_kb = 0;
+  };
+
+  struct Histogram {
+    size_t count = 0;
+    Clock::duration total{};
+    Clock::duration max{};
+    std::array<size_t, BUCKET_COUNT> buckets{};
+  };
+
+  // Время повторных вызовов этапа суммируется
+  void AddPhase(const std::string &name, Clock::duration duration);
+
+  void AddRequest(const std::string &type, Clock::duration duration);
+
+  // Значение счётчика, например числа попаданий в кэш, повторная установка заменяет его
+  void SetCounter(const std::string &name, size_t value);
+
+  [[nodiscard]] std::vector<Phase> GetPhases() const;
+
+  [[nodiscard]] std::map<std::string, Histogram> GetRequests() const;
+
+  [[nodiscard]] std::map<std::string, size_t> GetCounters() const;
+
+  void Report(std::ostream &out) const;
+
+  static size_t GetBucket(Clock::duration duration);
+
+ private:
+  mutable std::mutex mutex_;
+  std::vector<Phase> phases_;
+  std::map<std::string, Histogram> requests_;
+  std::map<std::string, size_t> counters_;
+};
+
+// Замеряет время от создания до разрушения и добавляет его к этапу. Без профилировщика ничего не делает
+class ScopedTimer {
+ public:
+  ScopedTimer(Profiler *profiler, std::string phase);
+
+  ScopedTimer(const ScopedTimer &) = delete;
+  ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+  ~ScopedTimer();
+
+ private:
+  Profiler *profiler_;
+  std::string phase_;
+  Profiler::Clock::time_point start_;
+};
+
+}
@@ -1,10 +1,19 @@
 #include "request_handler.h"
-#include "json_builder.h"
+#include "json_writer.h"
 #include "json.h"
 #include "json_reader.h"
 
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <deque>
+#include <future>
+#include <unordered_map>
 #include <sstream>
 #include <fstream>
+#include <iostream>
 
 using namespace std;
 
@@ -15,6 +24,114 @@ using namespace renderer;
 using namespace transport_catalogue;
 using namespace routing;
 using namespace serialization;
+using namespace profiling;
+
+QuerySnapshot::QuerySnapshot(const TransportCatalogue &db,
+                             RenderSettings render_settings,
+                             TransportRouter router,
+                             optional<string> rendered_map,
+                             size_t route_cache_size)
+    : db_(db), renderer_(std::move(render_settings)), router_(std::move(router)), route_cache_(route_cache_size) {
+  if (rendered_map) {
+    rendered_map_ = std::move(*rendered_map);
+    call_once(rendered_map_flag_, [] {});
+  }
+}
+
+optional<detail::RouteStat> QuerySnapshot::GetRouteStat(string_view bus_name) const {
+  return db_.GetRouteStat(bus_name);
+}
+
+unique_ptr<set<string_view>> QuerySnapshot::GetBusesThroughStop(string_view stop_name) const {
+  return db_.GetBusesThroughStop(stop_name);
+}
+
+svg::Document QuerySnapshot::RenderMap() const {
+  return renderer_.RenderMap(db_.GetAllBuses(), db_.GetStops());
+}
+
+const string &QuerySnapshot::GetRenderedMap() const {
+  call_once(rendered_map_flag_, [this] {
+    rendered_map_ = renderer_.RenderMapToString(db_.GetAllBuses(), db_.GetStops());
+  });
+  return rendered_map_;
+}
+
+optional<RouteData> QuerySnapshot::BuildRoute(string_view from, string_view to) const {
+  if (route_cache_.GetCapacity() == 0) {
+    return router_.BuildRoute(from, to);
+  }
+  const auto &stops = db_.GetAllStops();
+  const auto from_it = stops.find(from);
+  const auto to_it = stops.find(to);
+  if (from_it == stops.end() || to_it == stops.end()) {
+    return router_.BuildRoute(from, to);
+  }
+  const uint64_t key = static_cast<uint64_t>(from_it->second->id) << 32 | to_it->second->id;
+  return route_cache_.GetOrCompute(key, [this, from, to] {
+    return router_.BuildRoute(from, to);
+  });
+}
+
+QuerySnapshot::RouteCache::Stats QuerySnapshot::GetRouteCacheStats() const {
+  return route_cache_.GetStats();
+}
+
+optional<QuerySnapshot::StopRoutes> QuerySnapshot::BuildRoutesFromStop(string_view from, bool with_items) const {
+  const auto &stops = db_.GetAllStops();
+  if (stops.find(from) == stops.end()) {
+    return nullopt;
+  }
+  vector<string_view> stop_names;
+  stop_names.reserve(stops.size());
+  for (const auto &[stop_name, stop] : stops) {
+    stop_names.push_back(stop_name);
+  }
+  sort(stop_names.begin(), stop_names.end());
+
+  auto routes = router_.BuildRoutes(from, stop_names, with_items);
+  StopRoutes result;
+  for (size_t i = 0; i < stop_names.size(); ++i) {
+    if (routes[i]) {
+      result.emplace_back(stop_names[i], std::move(*routes[i]));
+    }
+  }
+  return result;
+}
+
+optional<QuerySnapshot::ReachableStops> QuerySnapshot::BuildIsochrone(string_view from, double max_time) const {
+  if (db_.GetAllStops().count(from) == 0) {
+    return nullopt;
+  }
+  return router_.BuildReachableStops(from, max_time);
+}
+
+string QuerySnapshot::RenderIsochroneMap(const ReachableStops &stops) const {
+  const auto &all_stops = db_.GetAllStops();
+  vector<detail::StopId> stop_ids;
+  stop_ids.reserve(stops.size());
+  for (const auto &[stop_name, _] : stops) {
+    stop_ids.push_back(all_stops.at(stop_name)->id);
+  }
+  return renderer_.RenderMapToString(db_.GetAllBuses(), db_.GetStops(), stop_ids);
+}
+
+vector<vector<optional<RouteData>>> QuerySnapshot::BuildRouteMatrix(const vector<string> &stops,
+                                                                    const vector<string> &targets,
+                                                                    bool with_items) const {
+  const auto &target_names = targets.empty() ? stops : targets;
+  const vector<string_view> to(target_names.begin(), target_names.end());
+  vector<vector<optional<RouteData>>> result;
+  result.reserve(stops.size());
+  for (const auto &from : stops) {
+    result.push_back(router_.BuildRoutes(from, to, with_items));
+  }
+  return result;
+}
+
+const TransportRouter &QuerySnapshot::GetRouter() const {
+  return router_;
+}
 
 RequestHandler::RequestHandler(TransportCatalogue &db)
     : db_(db) {}
@@ -31,7 +148,7 @@ svg::Document RequestHandler::RenderMap(RenderSettings render_settings) const {
   if (!renderer_.has_value()) {
     renderer_.emplace(MapRenderer(std::move(render_settings)));
   }
-  return renderer_->RenderMap(db_.GetAllBuses(), db_.GetAllStops());
+  return renderer_->RenderMap(db_.GetAllBuses(), db_.GetStops());
 }
 
 optional<RouteData> RequestHandler::BuildRoute(RoutingSettings routing_settings,
@@ -43,44 +160,299 @@ optional<RouteData> RequestHandler::BuildRoute(RoutingSettings routing_settings,
   return router_->BuildRoute(from, to);
 }
 
+QuerySnapshot RequestHandler::MakeSnapshot(RenderSettings render_settings,
+                                           RoutingSettings routing_settings,
+                                           size_t route_cache_size) const {
+  return {db_, std::move(render_settings), TransportRouter(db_, routing_settings), nullopt, route_cache_size};
+}
+
 void RequestHandler::ProcessMakeBaseRequest(istream &input) {
-  const auto request_collections = JsonReader::GetParsedBaseRequests(input);
   JsonReader json_reader(db_);
-  auto serialization_settings =
-      JsonReader::GetSerializationSettings(request_collections.serialization_settings);
-  auto render_settings = JsonReader::GetMapSettings(request_collections.render_settings);
-  auto routing_settings = JsonReader::GetRoutingSettings(request_collections.routing_settings);
-  json_reader.AddTransportCatalogueData(request_collections.base_requests);
+  const auto settings = json_reader.ReadBaseRequests(input);
+  auto serialization_settings = JsonReader::GetSerializationSettings(settings.serialization_settings);
+  auto render_settings = JsonReader::GetMapSettings(settings.render_settings);
+  auto routing_settings = JsonReader::GetRoutingSettings(settings.routing_settings);
   Serialize(serialization_settings, db_, render_settings, TransportRouter(db_, routing_settings));
 }
 
+namespace {
+
+bool IsBlank(string_view line) {
+  return line.find_first_not_of(" \t\r"sv) == string_view::npos;
+}
+
+optional<Profiler> MakeProfiler(const ExecutionSettings &settings) {
+  return settings.profile_output.empty() ? nullopt : make_optional<Profiler>();
+}
+
+// В отчёт добавляется статистика кэша маршрутов снимка
+void ReportProfile(Profiler &profiler, const QuerySnapshot &snapshot, const string &profile_output) {
+  const auto route_cache_stats = snapshot.GetRouteCacheStats();
+  profiler.SetCounter("route_cache_hits"s, route_cache_stats.hits);
+  profiler.SetCounter("route_cache_misses"s, route_cache_stats.misses);
+  if (profile_output == "stderr"s) {
+    profiler.Report(cerr);
+    return;
+  }
+  ofstream output(profile_output);
+  if (!output) {
+    throw runtime_error("Cannot open "s + profile_output + " for writing"s);
+  }
+  profiler.Report(output);
+}
+
+}
+
 void RequestHandler::ProcessRequests(istream &input, ostream &output) {
-  const auto request_collections = JsonReader::GetParsedStatRequests(input);
-  auto serialization_settings =
-      JsonReader::GetSerializationSettings(request_collections.serialization_settings);
-  const auto parsed_requests =
-      JsonReader::GetTransportCatalogueRequests(request_collections.stat_requests);
-  auto [render_settings, router] = Deserialize(serialization_settings, db_);
-  router_.emplace(std::move(router));
-  Builder json_builder;
-  json_builder.StartArray();
-  for (const auto &req : parsed_requests) {
-    if (req.type == JsonReader::BUS) {
-      const auto route_stat = GetRouteStat(req.name);
-      json_builder.Value(JsonReader::GetBusStatJson(req.id, route_stat));
-    } else if (req.type == JsonReader::STOP) {
-      auto stops_stat = GetBusesThroughStop(req.name);
-      json_builder.Value(JsonReader::GetStopStatJson(req.id, std::move(stops_stat)));
-    } else if (req.type == JsonReader::MAP) {
-      ostringstream buffer;
-      RenderMap(render_settings).Render(buffer);
-      json_builder.Value(JsonReader::GetMapStatJson(req.id, buffer.str()));
-    } else if (req.type == JsonReader::ROUTE) {
-      auto route = BuildRoute(router_->GetRoutingSettings(), req.from, req.to);
-      json_builder.Value(JsonReader::GetRouteStatJson(req.id, route));
+  // Настройки замеров известны только после разбора, поэтому разбор замеряется всегда
+  const auto read_start = Profiler::Clock::now();
+  const auto stat_requests = JsonReader::ReadStatRequests(input);
+  const auto read_duration = Profiler::Clock::now() - read_start;
+  auto serialization_settings = JsonReader::GetSerializationSettings(stat_requests.serialization_settings);
+  const auto execution_settings = JsonReader::GetExecutionSettings(stat_requests.execution_settings);
+  auto profiler = MakeProfiler(execution_settings);
+  Profiler *profiler_ptr = profiler ? &*profiler : nullptr;
+  if (profiler) {
+    profiler->AddPhase("read_stat_requests"s, read_duration);
+  }
+
+  const auto &parsed_requests = stat_requests.requests;
+  auto database = [&] {
+    ScopedTimer timer(profiler_ptr, "deserialize"s);
+    return Deserialize(serialization_settings, db_);
+  }();
+  const QuerySnapshot snapshot(db_,
+                               std::move(database.render_settings),
+                               std::move(database.router),
+                               std::move(database.rendered_map),
+                               execution_settings.route_cache_size);
+  {
+    ScopedTimer timer(profiler_ptr, "process_requests"s);
+    // Каждый ответ выводится сразу после вычисления, весь массив ответов в памяти не хранится
+    Writer json_writer(output);
+    json_writer.StartArray();
+    if (execution_settings.mode == ExecutionMode::PARALLEL) {
+      ProcessRequestsInParallel(parsed_requests, snapshot, execution_settings.thread_count, profiler_ptr, json_writer);
+    } else {
+      ProcessRequestsSequentially(parsed_requests, snapshot, profiler_ptr, json_writer);
+    }
+    json_writer.EndArray();
+  }
+  if (profiler) {
+    ReportProfile(*profiler, snapshot, execution_settings.profile_output);
+  }
+}
+
+void RequestHandler::Serve(istream &input, ostream &output) {
+  string line;
+  bool has_settings = false;
+  while (!has_settings && getline(input, line)) {
+    has_settings = !IsBlank(line);
+  }
+  if (!has_settings) {
+    return;
+  }
+  const auto settings = JsonReader::ReadServeSettings(line);
+  auto serialization_settings = JsonReader::GetSerializationSettings(settings.serialization_settings);
+  const auto execution_settings = JsonReader::GetExecutionSettings(settings.execution_settings);
+  auto profiler = MakeProfiler(execution_settings);
+  Profiler *profiler_ptr = profiler ? &*profiler : nullptr;
+  auto database = [&] {
+    ScopedTimer timer(profiler_ptr, "deserialize"s);
+    return Deserialize(serialization_settings, db_);
+  }();
+  const QuerySnapshot snapshot(db_,
+                               std::move(database.render_settings),
+                               std::move(database.router),
+                               std::move(database.rendered_map),
+                               execution_settings.route_cache_size);
+
+  while (getline(input, line)) {
+    if (IsBlank(line)) {
+      continue;
+    }
+    Node answer;
+    try {
+      const FlatDocument document(std::move(line));
+      const auto request = JsonReader::GetTransportCatalogueRequest(document.GetRoot());
+      auto result = ProcessRequest(request, snapshot, profiler_ptr);
+      answer = result ? std::move(*result) : JsonReader::GetInvalidRequestJson("unknown request type"s, request.id);
+    } catch (const exception &e) {
+      // Ошибка в одном запросе не останавливает сервер
+      answer = JsonReader::GetInvalidRequestJson(e.what());
     }
+    PrintCompact(Document{std::move(answer)}, output);
+    output << '\n';
+    output.flush();
+  }
+  // Отчёт выводится, когда вход закончился
+  if (profiler) {
+    ReportProfile(*profiler, snapshot, execution_settings.profile_output);
+  }
+}
+
+optional<Node> RequestHandler::ProcessRequest(const Request &req, const QuerySnapshot &snapshot, Profiler *profiler) {
+  if (profiler) {
+    const auto start = Profiler::Clock::now();
+    auto answer = ProcessRequest(req, snapshot);
+    profiler->AddRequest(req.type, Profiler::Clock::now() - start);
+    return answer;
+  }
+  if (req.type == JsonReader::BUS) {
+    const auto route_stat = snapshot.GetRouteStat(req.name);
+    return JsonReader::GetBusStatJson(req.id, route_stat);
+  }
+  if (req.type == JsonReader::STOP) {
+    auto stops_stat = snapshot.GetBusesThroughStop(req.name);
+    return JsonReader::GetStopStatJson(req.id, std::move(stops_stat));
+  }
+  if (req.type == JsonReader::MAP) {
+    return JsonReader::GetMapStatJson(req.id, snapshot.GetRenderedMap());
+  }
+  if (req.type == JsonReader::ROUTE) {
+    auto route = snapshot.BuildRoute(req.from, req.to);
+    return JsonReader::GetRouteStatJson(req.id, route);
+  }
+  if (req.type == JsonReader::ROUTE_FROM_STOP) {
+    return JsonReader::GetRoutesFromStopJson(req.id, snapshot.BuildRoutesFromStop(req.from, req.with_items), req.with_items);
+  }
+  if (req.type == JsonReader::ROUTE_MATRIX) {
+    const auto routes = snapshot.BuildRouteMatrix(req.stops, req.targets, req.with_items);
+    return JsonReader::GetRouteMatrixJson(req.id, routes, req.with_items);
+  }
+  if (req.type == JsonReader::ISOCHRONE) {
+    const auto stops = snapshot.BuildIsochrone(req.from, req.max_time);
+    optional<string> map;
+    if (stops && req.render_map) {
+      map = snapshot.RenderIsochroneMap(*stops);
+    }
+    return JsonReader::GetIsochroneJson(req.id, stops, map);
+  }
+  return nullopt;
+}
+
+RequestHandler::RequestGroups RequestHandler::GroupRequests(const vector<Request> &requests) {
+  RequestGroups groups;
+  groups.group_of_request.reserve(requests.size());
+  unordered_map<string, size_t> group_by_key;
+  string key;
+  array<char, 32> max_time_buffer{};
+  for (size_t i = 0; i < requests.size(); ++i) {
+    const auto &req = requests[i];
+    // Ответ зависит только от полей запроса, кроме id, '\0' и '\1' в именах не встречаются
+    key.clear();
+    key.append(req.type).append(1, '\0').append(req.name).append(1, '\0').append(req.from).append(1, '\0').append(req.to);
+    for (const auto *stops : {&req.stops, &req.targets}) {
+      key.append(1, '\1');
+      for (const auto &stop : *stops) {
+        key.append(1, '\0').append(stop);
+      }
+    }
+    key.append(1, req.with_items ? '1' : '0').append(1, req.render_map ? '1' : '0');
+    // Кратчайшая запись числа однозначна, -0 и 0 дают одинаковый ответ и записываются одинаково
+    const auto [max_time_end, _] = to_chars(max_time_buffer.data(), max_time_buffer.data() + max_time_buffer.size(),
+                                            req.max_time == 0. ? 0. : req.max_time);
+    key.append(max_time_buffer.data(), max_time_end);
+    const auto [it, inserted] = group_by_key.emplace(key, groups.first_requests.size());
+    if (inserted) {
+      groups.first_requests.push_back(i);
+      groups.last_requests.push_back(i);
+    } else {
+      groups.last_requests[it->second] = i;
+    }
+    groups.group_of_request.push_back(it->second);
+  }
+  return groups;
+}
+
+void RequestHandler::WriteAnswer(optional<Node> &answer, int id, bool is_last, Writer &json_writer) {
+  if (!answer) {
+    return;
+  }
+  // После последнего запроса группы ответ больше не нужен и переносится без копирования
+  if (is_last) {
+    json_writer.Value(JsonReader::SetRequestId(std::move(*answer), id));
+    answer.reset();
+  } else {
+    json_writer.Value(JsonReader::SetRequestId(*answer, id));
+  }
+}
+
+// Одинаковые запросы пакета выполняются один раз, ответ выводится для каждого из них со своим id.
+// Группы запросов делятся на блоки, которые свободные потоки пула забирают из общей очереди,
+// поэтому долгие запросы Route не задерживают остальные потоки. Ответы выводятся в порядке
+// запросов, а число ожидающих вывода блоков ограничено, чтобы память не росла с числом запросов
+void RequestHandler::ProcessRequestsInParallel(const vector<Request> &requests,
+                                               const QuerySnapshot &snapshot,
+                                               size_t thread_count,
+                                               Profiler *profiler,
+                                               Writer &json_writer) {
+  const auto groups = GroupRequests(requests);
+  const size_t group_count = groups.first_requests.size();
+  concurrency::ThreadPool pool(thread_count > 0 ? thread_count : concurrency::ThreadPool::GetDefaultThreadCount());
+  const size_t max_pending_blocks = pool.GetThreadCount() * PARALLEL_BLOCKS_PER_THREAD;
+  deque<future<vector<optional<Node>>>> pending_blocks;
+  size_t next_group = 0;
+  const auto submit_block = [&] {
+    const size_t begin = next_group;
+    const size_t end = min(begin + PARALLEL_BLOCK_SIZE, group_count);
+    next_group = end;
+    pending_blocks.push_back(pool.Submit([&requests, &groups, &snapshot, profiler, begin, end] {
+      vector<optional<Node>> answers;
+      answers.reserve(end - begin);
+      for (size_t group = begin; group < end; ++group) {
+        answers.push_back(ProcessRequest(requests[groups.first_requests[group]], snapshot, profiler));
+      }
+      return answers;
+    }));
+  };
+
+  while (next_group < group_count && pending_blocks.size() < max_pending_blocks) {
+    submit_block();
+  }
+  // Группа появляется в порядке первого запроса, поэтому к выводу запроса её блок уже отправлен в пул
+  vector<optional<Node>> answers(group_count);
+  size_t ready_groups = 0;
+  Profiler::Clock::duration write_duration{};
+  for (size_t i = 0; i < requests.size(); ++i) {
+    const size_t group = groups.group_of_request[i];
+    while (group >= ready_groups) {
+      auto block = pending_blocks.front().get();
+      pending_blocks.pop_front();
+      if (next_group < group_count) {
+        submit_block();
+      }
+      move(block.begin(), block.end(), answers.begin() + static_cast<ptrdiff_t>(ready_groups));
+      ready_groups += block.size();
+    }
+    const auto write_start = Profiler::Clock::now();
+    WriteAnswer(answers[group], requests[i].id, groups.last_requests[group] == i, json_writer);
+    write_duration += Profiler::Clock::now() - write_start;
+  }
+  if (profiler) {
+    profiler->AddPhase("write_answers"s, write_duration);
+  }
+}
+
+void RequestHandler::ProcessRequestsSequentially(const vector<Request> &requests,
+                                                 const QuerySnapshot &snapshot,
+                                                 Profiler *profiler,
+                                                 Writer &json_writer) {
+  const auto groups = GroupRequests(requests);
+  vector<optional<Node>> answers(groups.first_requests.size());
+  Profiler::Clock::duration write_duration{};
+  for (size_t i = 0; i < requests.size(); ++i) {
+    const size_t group = groups.group_of_request[i];
+    if (groups.first_requests[group] == i) {
+      answers[group] = ProcessRequest(requests[i], snapshot, profiler);
+    }
+    const auto write_start = Profiler::Clock::now();
+    WriteAnswer(answers[group], requests[i].id, groups.last_requests[group] == i, json_writer);
+    write_duration += Profiler::Clock::now() - write_start;
+  }
+  if (profiler) {
+    profiler->AddPhase("write_answers"s, write_duration);
   }
-  Print(json::Document(json_builder.EndArray().Build()), output);
 }
 
 }
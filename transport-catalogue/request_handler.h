@@ -3,13 +3,99 @@
 #include "transport_catalogue.h"
 #include "map_renderer.h"
 #include "transport_router.h"
+#include "json.h"
+#include "lru_cache.h"
+#include "profiler.h"
 
 #include <set>
 #include <string_view>
 #include <optional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace json {
+class Writer;
+}
 
 namespace request {
 
+struct Request;
+
+enum class ExecutionMode { SEQUENTIAL, PARALLEL };
+
+struct ExecutionSettings {
+  ExecutionMode mode = ExecutionMode::SEQUENTIAL;
+  // 0 - по числу аппаратных потоков
+  size_t thread_count = 0;
+  // Число маршрутов в кэше запросов Route, 0 - кэш отключён
+  size_t route_cache_size = 4096;
+  // Куда вывести время этапов и гистограммы времени запросов: "stderr" или путь к файлу.
+  // Пустая строка - замеры не ведутся
+  std::string profile_output;
+};
+
+// Полностью инициализированный набор данных для ответов на запросы. Каталог, настройки карты
+// и маршрутизатор после создания не меняются, все методы константные, поэтому один снимок
+// можно использовать из нескольких потоков. Изменяемые члены синхронизированы сами:
+// текст карты отрисовывается один раз под std::call_once, кэш маршрутов блокирует свои сегменты
+class QuerySnapshot {
+ public:
+  QuerySnapshot(const transport_catalogue::TransportCatalogue &db,
+                renderer::RenderSettings render_settings,
+                routing::TransportRouter router,
+                std::optional<std::string> rendered_map = std::nullopt,
+                size_t route_cache_size = 0);
+
+  [[nodiscard]] std::optional<transport_catalogue::detail::RouteStat> GetRouteStat(std::string_view bus_name) const;
+
+  [[nodiscard]] std::unique_ptr<std::set<std::string_view>> GetBusesThroughStop(std::string_view stop_name) const;
+
+  [[nodiscard]] svg::Document RenderMap() const;
+
+  // Текст карты отрисовывается при первом обращении или берётся из базы и дальше не меняется
+  [[nodiscard]] const std::string &GetRenderedMap() const;
+
+  // Маршруты между известными остановками кэшируются, включая отсутствие маршрута
+  [[nodiscard]] std::optional<routing::RouteData> BuildRoute(std::string_view from, std::string_view to) const;
+
+  using RouteCache = concurrency::LruCache<uint64_t, std::optional<routing::RouteData>>;
+
+  [[nodiscard]] RouteCache::Stats GetRouteCacheStats() const;
+
+  using StopRoutes = std::vector<std::pair<std::string_view, routing::RouteData>>;
+
+  // Маршруты до всех достижимых остановок в порядке имён, найденные одним поиском.
+  // nullopt - остановка неизвестна
+  [[nodiscard]] std::optional<StopRoutes> BuildRoutesFromStop(std::string_view from, bool with_items) const;
+
+  using ReachableStops = std::vector<std::pair<std::string_view, double>>;
+
+  // Остановки, до которых из from можно доехать не дольше max_time, в порядке возрастания времени.
+  // nullopt - остановка неизвестна
+  [[nodiscard]] std::optional<ReachableStops> BuildIsochrone(std::string_view from, double max_time) const;
+
+  // Карта, на которой выделены остановки stops
+  [[nodiscard]] std::string RenderIsochroneMap(const ReachableStops &stops) const;
+
+  // Один поиск на каждую остановку отправления, targets пуст - назначения совпадают с отправлениями
+  [[nodiscard]] std::vector<std::vector<std::optional<routing::RouteData>>> BuildRouteMatrix(
+      const std::vector<std::string> &stops,
+      const std::vector<std::string> &targets,
+      bool with_items) const;
+
+  [[nodiscard]] const routing::TransportRouter &GetRouter() const;
+
+ private:
+  const transport_catalogue::TransportCatalogue &db_;
+  const renderer::MapRenderer renderer_;
+  const routing::TransportRouter router_;
+  mutable std::once_flag rendered_map_flag_;
+  mutable std::string rendered_map_;
+  // Сегменты кэша защищены своими мьютексами, статистика попаданий выводится в отчёт профилировщика
+  mutable RouteCache route_cache_;
+};
+
 class RequestHandler {
  public:
   using OptinalRouteStat = std::optional<transport_catalogue::detail::RouteStat>;
@@ -26,14 +112,56 @@ class RequestHandler {
                                                std::string_view from,
                                                std::string_view to) const;
 
+  // Снимок строится сразу, в отличие от ленивой инициализации в RenderMap и BuildRoute
+  [[nodiscard]] QuerySnapshot MakeSnapshot(renderer::RenderSettings render_settings,
+                                           routing::RoutingSettings routing_settings,
+                                           size_t route_cache_size = 0) const;
+
   void ProcessMakeBaseRequest(std::istream &input);
 
   void ProcessRequests(std::istream &input, std::ostream &output);
 
+  // Режим сервера: первая строка входа содержит настройки сериализации, база загружается один раз,
+  // затем на каждую строку с запросом выводится строка с ответом
+  void Serve(std::istream &input, std::ostream &output);
+
  private:
+  // Число запросов в задаче пула при параллельной обработке
+  static const size_t PARALLEL_BLOCK_SIZE = 32;
+  // Сколько задач на поток может ожидать вывода, пока не выведены более ранние ответы
+  static const size_t PARALLEL_BLOCKS_PER_THREAD = 4;
+
   transport_catalogue::TransportCatalogue &db_;
   mutable std::optional<renderer::MapRenderer> renderer_{std::nullopt};
   mutable std::optional<routing::TransportRouter> router_{std::nullopt};
+
+  // Одинаковые запросы пакета, различающиеся только id
+  struct RequestGroups {
+    // Номер группы для каждого запроса, группы нумеруются в порядке первого запроса
+    std::vector<size_t> group_of_request;
+    std::vector<size_t> first_requests;
+    std::vector<size_t> last_requests;
+  };
+
+  static RequestGroups GroupRequests(const std::vector<Request> &requests);
+
+  static void WriteAnswer(std::optional<json::Node> &answer, int id, bool is_last, json::Writer &json_writer);
+
+  // Ответ на запрос, для запроса неизвестного типа ответа нет
+  static std::optional<json::Node> ProcessRequest(const Request &request,
+                                                  const QuerySnapshot &snapshot,
+                                                  profiling::Profiler *profiler = nullptr);
+
+  static void ProcessRequestsSequentially(const std::vector<Request> &requests,
+                                          const QuerySnapshot &snapshot,
+                                          profiling::Profiler *profiler,
+                                          json::Writer &json_writer);
+
+  static void ProcessRequestsInParallel(const std::vector<Request> &requests,
+                                        const QuerySnapshot &snapshot,
+                                        size_t thread_count,
+                                        profiling::Profiler *profiler,
+                                        json::Writer &json_writer);
 };
 
 }
\ No newline at end of file
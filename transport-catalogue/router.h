@@ -15,32 +15,89 @@
 namespace graph {
 
 template<typename Weight>
-class Router {
- private:
-  using Graph = DirectedWeightedGraph<Weight>;
+struct RouteInfo {
+  Weight weight;
+  std::vector<EdgeId> edges;
+};
 
- public:
-  explicit Router(const Graph &graph);
+// Проверяет, что кратчайшие пути, например прочитанные из файла, подходят к графу: для каждой начальной вершины
+// последние рёбра путей образуют дерево с корнем в ней, поэтому восстановление пути конечно
+template<typename RoutesInternalData, typename Graph>
+bool IsValidAllPairsRoutes(const RoutesInternalData &routes_internal_data, const Graph &graph) {
+  const size_t vertex_count = graph.GetVertexCount();
+  const size_t edge_count = graph.GetEdgeCount();
+  if (routes_internal_data.size() != vertex_count) {
+    return false;
+  }
+  // 0 - вершина не проверена, 1 - лежит на проверяемом пути, 2 - путь до неё проверен
+  std::vector<uint8_t> states;
+  std::vector<VertexId> path;
+  for (VertexId from = 0; from < vertex_count; ++from) {
+    const auto &routes = routes_internal_data[from];
+    if (routes.size() != vertex_count) {
+      return false;
+    }
+    states.assign(vertex_count, 0);
+    for (VertexId to = 0; to < vertex_count; ++to) {
+      path.clear();
+      for (VertexId vertex = to; routes[vertex] && states[vertex] != 2;) {
+        if (states[vertex] == 1) {
+          return false;
+        }
+        states[vertex] = 1;
+        path.push_back(vertex);
+        const auto &prev_edge = routes[vertex]->prev_edge;
+        if (!prev_edge) {
+          if (vertex != from) {
+            return false;
+          }
+          break;
+        }
+        if (*prev_edge >= edge_count) {
+          return false;
+        }
+        const auto &edge = graph.GetEdge(*prev_edge);
+        if (edge.to != vertex || !routes[edge.from]) {
+          return false;
+        }
+        vertex = edge.from;
+      }
+      for (const VertexId vertex : path) {
+        states[vertex] = 2;
+      }
+    }
+  }
+  return true;
+}
 
-  struct RouteInfo {
+template<typename Weight, typename Graph = DirectedWeightedGraph<Weight>>
+class Router {
+ public:
+  struct RouteInternalData {
     Weight weight;
-    std::vector<EdgeId> edges;
+    std::optional<EdgeId> prev_edge;
   };
+  using RoutesInternalData = std::vector<std::vector<std::optional<RouteInternalData>>>;
+
+  explicit Router(const Graph &graph);
+
+  // Восстанавливает маршрутизатор по ранее посчитанным кратчайшим путям без их пересчёта
+  Router(const Graph &graph, RoutesInternalData routes_internal_data);
+
+  using RouteInfo = graph::RouteInfo<Weight>;
 
   std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const;
 
+  [[nodiscard]] const RoutesInternalData &GetRoutesInternalData() const;
+
  private:
-  struct RouteInternalData {
-    Weight weight;
-    std::optional<EdgeId> prev_edge;
-  };
-  using RoutesInternalData = std::vector<std::vector<std::optional<RouteInternalData>>>;
 
   void InitializeRoutesInternalData(const Graph &graph) {
     const size_t vertex_count = graph.GetVertexCount();
     for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
       routes_internal_data_[vertex][vertex] = RouteInternalData{ZERO_WEIGHT, std::nullopt};
-      for (const EdgeId edge_id : graph.GetIncidentEdges(vertex)) {
+      for (const auto &incident_edge : graph.GetIncidentEdges(vertex)) {
+        const EdgeId edge_id = GetIncidentEdge<Weight>(graph, incident_edge).id;
         const auto &edge = graph.GetEdge(edge_id);
         if (edge.weight < ZERO_WEIGHT) {
           throw std::domain_error("Edges' weights should be non-negative");
@@ -81,7 +138,13 @@ class Router {
 };
 
 template<typename Weight>
-Router<Weight>::Router(const Graph &graph)
+Router(const DirectedWeightedGraph<Weight> &) -> Router<Weight>;
+
+template<typename Weight>
+Router(const CsrGraph<Weight> &) -> Router<Weight, CsrGraph<Weight>>;
+
+template<typename Weight, typename Graph>
+Router<Weight, Graph>::Router(const Graph &graph)
     : graph_(graph), routes_internal_data_(graph.GetVertexCount(),
                                            std::vector<std::optional<RouteInternalData>>(graph.GetVertexCount())) {
   InitializeRoutesInternalData(graph);
@@ -92,9 +155,17 @@ Router<Weight>::Router(const Graph &graph)
   }
 }
 
-template<typename Weight>
-std::optional<typename Router<Weight>::RouteInfo> Router<Weight>::BuildRoute(VertexId from,
-                                                                             VertexId to) const {
+template<typename Weight, typename Graph>
+Router<Weight, Graph>::Router(const Graph &graph, RoutesInternalData routes_internal_data)
+    : graph_(graph), routes_internal_data_(std::move(routes_internal_data)) {
+  if (!IsValidAllPairsRoutes(routes_internal_data_, graph)) {
+    throw std::invalid_argument("Routes data does not match the graph");
+  }
+}
+
+template<typename Weight, typename Graph>
+std::optional<typename Router<Weight, Graph>::RouteInfo> Router<Weight, Graph>::BuildRoute(VertexId from,
+                                                                                           VertexId to) const {
   const auto &route_internal_data = routes_internal_data_.at(from).at(to);
   if (!route_internal_data) {
     return std::nullopt;
@@ -111,4 +182,9 @@ std::optional<typename Router<Weight>::RouteInfo> Router<Weight>::BuildRoute(Ver
   return RouteInfo{weight, std::move(edges)};
 }
 
+template<typename Weight, typename Graph>
+const typename Router<Weight, Graph>::RoutesInternalData &Router<Weight, Graph>::GetRoutesInternalData() const {
+  return routes_internal_data_;
+}
+
 }  // namespace graph
\ No newline at end of file
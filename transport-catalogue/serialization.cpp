@@ -1,4 +1,5 @@
 #include "serialization.h"
+#include "flat_serialization.h"
 
 #include <transport_catalogue.pb.h>
 #include <map_renderer.pb.h>
@@ -16,6 +17,9 @@ using namespace renderer;
 using namespace svg;
 using namespace routing;
 
+// Версия устройства сохраняемого индекса маршрутизатора, индексы других версий при загрузке отбрасываются
+const uint32_t ROUTER_INDEX_VERSION = 1;
+
 unordered_map<string_view, int> GetStopIds(const unordered_map<string_view, TransportCatalogue::PtrStop> &stops) {
   const auto sorted_stops = GetSortedUnorderedMapKeys(stops);
   unordered_map<string_view, int> stop_ids;
@@ -27,10 +31,20 @@ unordered_map<string_view, int> GetStopIds(const unordered_map<string_view, Tran
   return stop_ids;
 }
 
+// В файле остановки нумеруются по алфавиту, здесь номер в файле берётся по StopId
+vector<int> GetProtoStopIds(const TransportCatalogue &catalogue) {
+  const auto stop_ids = GetStopIds(catalogue.GetAllStops());
+  vector<int> proto_stop_ids(catalogue.GetStopCount());
+  for (const auto &stop : catalogue.GetStops()) {
+    proto_stop_ids[stop->id] = stop_ids.at(stop->name);
+  }
+  return proto_stop_ids;
+}
+
 proto_tc::TransportCatalogueData SerializeTransportCatalogue(const TransportCatalogue &catalogue) {
   proto_tc::TransportCatalogueData proto_catalogue_data;
   const auto &stops = catalogue.GetAllStops();
-  const auto stop_ids = GetStopIds(stops);
+  const auto proto_stop_ids = GetProtoStopIds(catalogue);
   const auto &buses = catalogue.GetAllBuses();
   const auto &distances = catalogue.GetAllDistances();
 
@@ -46,16 +60,21 @@ proto_tc::TransportCatalogueData SerializeTransportCatalogue(const TransportCata
     proto_tc::Bus proto_bus;
     proto_bus.set_name(bus->name);
     proto_bus.set_is_circular(bus->route_type == RouteType::CIRCULAR);
-    for (string_view stop : bus->stops_on_route) {
-      proto_bus.add_stops_on_route(stop_ids.at(stop));
+    for (const auto stop_id : bus->stop_ids_on_route) {
+      proto_bus.add_stops_on_route(proto_stop_ids[stop_id]);
     }
+    auto &proto_route_stat = *proto_bus.mutable_route_stat();
+    proto_route_stat.set_unique_stops_count(bus->unique_stops_count);
+    proto_route_stat.set_geo_route_distance(bus->geo_route_distance);
+    proto_route_stat.set_route_distance(bus->route_distance);
+    proto_route_stat.set_curvature(bus->curvature);
     proto_catalogue_data.mutable_buses()->Add(std::move(proto_bus));
   }
 
   for (const auto &[stops_pair, distance] : distances) {
     proto_tc::StopsDistance proto_distance;
-    proto_distance.set_stop_from(stop_ids.at(stops_pair.first->name));
-    proto_distance.set_stop_to(stop_ids.at(stops_pair.second->name));
+    proto_distance.set_stop_from(proto_stop_ids[stops_pair.first]);
+    proto_distance.set_stop_to(proto_stop_ids[stops_pair.second]);
     proto_distance.set_distance(distance);
     proto_catalogue_data.mutable_distances()->Add(std::move(proto_distance));
   }
@@ -74,22 +93,37 @@ TransportCatalogue DeserializeTransportCatalogue(TransportCatalogue &catalogue,
   }
 
   const auto id_stops = GetSortedUnorderedMapKeys(catalogue.GetAllStops());
+  vector<StopId> stop_ids;
+  stop_ids.reserve(id_stops.size());
+  for (const auto stop : id_stops) {
+    stop_ids.push_back(catalogue.GetStopId(stop));
+  }
 
   for (const auto &proto_distance : proto_catalogue_data.distances()) {
-    auto from = id_stops.at(static_cast<int>(proto_distance.stop_from()));
-    auto to = id_stops.at(static_cast<int>(proto_distance.stop_to()));
-    catalogue.AddDistance({string(from), string(to), static_cast<int>(proto_distance.distance())});
+    catalogue.AddDistance(stop_ids.at(proto_distance.stop_from()),
+                          stop_ids.at(proto_distance.stop_to()),
+                          static_cast<int>(proto_distance.distance()));
   }
 
   for (const auto &proto_bus : proto_catalogue_data.buses()) {
     Bus bus;
     bus.name = proto_bus.name();
     bus.route_type = proto_bus.is_circular() ? RouteType::CIRCULAR : RouteType::LINEAR;
-    bus.stops_on_route.reserve(proto_bus.stops_on_route().size());
+    bus.stop_ids_on_route.reserve(proto_bus.stops_on_route().size());
     for (auto stop_id : proto_bus.stops_on_route()) {
-      bus.stops_on_route.emplace_back(id_stops.at(static_cast<int>(stop_id)));
+      bus.stop_ids_on_route.push_back(stop_ids.at(stop_id));
     }
-    catalogue.AddBus(std::move(bus));
+    // Базы без сохранённой статистики маршрутов по-прежнему загружаются с её пересчётом
+    if (!proto_bus.has_route_stat()) {
+      catalogue.AddBus(std::move(bus));
+      continue;
+    }
+    const auto &proto_route_stat = proto_bus.route_stat();
+    bus.unique_stops_count = proto_route_stat.unique_stops_count();
+    bus.geo_route_distance = proto_route_stat.geo_route_distance();
+    bus.route_distance = static_cast<int>(proto_route_stat.route_distance());
+    bus.curvature = proto_route_stat.curvature();
+    catalogue.AddBusWithRouteStat(std::move(bus));
   }
 
   return catalogue;
@@ -216,6 +250,113 @@ RenderSettings DeserializeRenderSettings(const proto_tc::RenderSettings &proto_s
   return render_settings;
 }
 
+proto_tc::RouterType SerializeRouterType(RouterType router_type) {
+  switch (router_type) {
+    case RouterType::DIJKSTRA:return proto_tc::DIJKSTRA;
+    case RouterType::ALL_PAIRS:return proto_tc::ALL_PAIRS;
+    case RouterType::CONTRACTION_HIERARCHY:return proto_tc::CONTRACTION_HIERARCHY;
+  }
+  return proto_tc::DIJKSTRA;
+}
+
+RouterType DeserializeRouterType(proto_tc::RouterType proto_router_type) {
+  switch (proto_router_type) {
+    case proto_tc::ALL_PAIRS:return RouterType::ALL_PAIRS;
+    case proto_tc::CONTRACTION_HIERARCHY:return RouterType::CONTRACTION_HIERARCHY;
+    default:break;
+  }
+  return RouterType::DIJKSTRA;
+}
+
+proto_tc::GraphModel SerializeGraphModel(GraphModel graph_model) {
+  switch (graph_model) {
+    case GraphModel::STOP_PAIRS:return proto_tc::STOP_PAIRS;
+    case GraphModel::RIDE_VERTICES:return proto_tc::RIDE_VERTICES;
+  }
+  return proto_tc::STOP_PAIRS;
+}
+
+GraphModel DeserializeGraphModel(proto_tc::GraphModel proto_graph_model) {
+  switch (proto_graph_model) {
+    case proto_tc::RIDE_VERTICES:return GraphModel::RIDE_VERTICES;
+    default:break;
+  }
+  return GraphModel::STOP_PAIRS;
+}
+
+proto_tc::ContractionHierarchy SerializeContractionHierarchy(
+    const TransportRouter::ContractionHierarchy &contraction_hierarchy) {
+  proto_tc::ContractionHierarchy proto_contraction_hierarchy;
+  for (const auto rank : contraction_hierarchy.ranks) {
+    proto_contraction_hierarchy.add_ranks(rank);
+  }
+  for (const auto &shortcut : contraction_hierarchy.shortcuts) {
+    auto &proto_shortcut = *proto_contraction_hierarchy.add_shortcuts();
+    proto_shortcut.set_from(shortcut.from);
+    proto_shortcut.set_to(shortcut.to);
+    proto_shortcut.set_weight(shortcut.weight);
+    proto_shortcut.set_first(shortcut.first);
+    proto_shortcut.set_second(shortcut.second);
+  }
+  return proto_contraction_hierarchy;
+}
+
+TransportRouter::ContractionHierarchy DeserializeContractionHierarchy(
+    const proto_tc::ContractionHierarchy &proto_contraction_hierarchy) {
+  TransportRouter::ContractionHierarchy contraction_hierarchy;
+  contraction_hierarchy.ranks.assign(proto_contraction_hierarchy.ranks().begin(),
+                                     proto_contraction_hierarchy.ranks().end());
+  contraction_hierarchy.shortcuts.reserve(proto_contraction_hierarchy.shortcuts_size());
+  for (const auto &proto_shortcut : proto_contraction_hierarchy.shortcuts()) {
+    contraction_hierarchy.shortcuts.push_back({proto_shortcut.from(),
+                                               proto_shortcut.to(),
+                                               proto_shortcut.weight(),
+                                               proto_shortcut.first(),
+                                               proto_shortcut.second()});
+  }
+  return contraction_hierarchy;
+}
+
+optional<proto_tc::AllPairsRoutes> SerializeAllPairsRoutes(const TransportRouter::AllPairsRoutes &all_pairs_routes) {
+  const size_t vertex_count = all_pairs_routes.size();
+  // Деление вместо умножения, чтобы не переполнить size_t
+  if (vertex_count > 0 && vertex_count > MAX_SERIALIZED_ALL_PAIRS_ROUTES / vertex_count) {
+    return nullopt;
+  }
+  proto_tc::AllPairsRoutes proto_all_pairs_routes;
+  proto_all_pairs_routes.mutable_weights()->Reserve(static_cast<int>(vertex_count * vertex_count));
+  proto_all_pairs_routes.mutable_prev_edges()->Reserve(static_cast<int>(vertex_count * vertex_count));
+  for (const auto &routes : all_pairs_routes) {
+    for (const auto &route : routes) {
+      proto_all_pairs_routes.add_weights(route ? route->weight : -1.);
+      proto_all_pairs_routes.add_prev_edges(route && route->prev_edge ? *route->prev_edge + 1 : 0);
+    }
+  }
+  return proto_all_pairs_routes;
+}
+
+optional<TransportRouter::AllPairsRoutes> DeserializeAllPairsRoutes(
+    const proto_tc::AllPairsRoutes &proto_all_pairs_routes,
+    size_t vertex_count) {
+  if (static_cast<size_t>(proto_all_pairs_routes.weights_size()) != vertex_count * vertex_count
+      || proto_all_pairs_routes.prev_edges_size() != proto_all_pairs_routes.weights_size()) {
+    return nullopt;
+  }
+  TransportRouter::AllPairsRoutes all_pairs_routes(vertex_count);
+  int index = 0;
+  for (auto &routes : all_pairs_routes) {
+    routes.resize(vertex_count);
+    for (auto &route : routes) {
+      const double weight = proto_all_pairs_routes.weights(index);
+      const uint64_t prev_edge = proto_all_pairs_routes.prev_edges(index++);
+      if (weight >= 0.) {
+        route = {weight, prev_edge > 0 ? optional<graph::EdgeId>(prev_edge - 1) : nullopt};
+      }
+    }
+  }
+  return all_pairs_routes;
+}
+
 proto_tc::TransportRouter SerializeTransportRouter(const TransportRouter &transport_router,
                                                    const TransportCatalogue &catalogue) {
   proto_tc::TransportRouter proto_transport_router;
@@ -225,6 +366,8 @@ proto_tc::TransportRouter SerializeTransportRouter(const TransportRouter &transp
   proto_tc::RoutingSettings proto_settings;
   proto_settings.set_bus_velocity(routing_settings.bus_velocity);
   proto_settings.set_bus_wait_time(routing_settings.bus_wait_time);
+  proto_settings.set_router_type(SerializeRouterType(routing_settings.router_type));
+  proto_settings.set_graph_model(SerializeGraphModel(routing_settings.graph_model));
   *proto_transport_router.mutable_routing_settings() = proto_settings;
   proto_transport_router.mutable_routing_settings()->set_bus_velocity(routing_settings.bus_velocity);
   proto_transport_router.mutable_routing_settings()->set_bus_wait_time(routing_settings.bus_wait_time);
@@ -244,7 +387,11 @@ proto_tc::TransportRouter SerializeTransportRouter(const TransportRouter &transp
     proto_bus_route_item.set_time(bus_route_item.time);
     proto_bus_route_item.set_bus(bus_route_item.bus);
     proto_bus_route_item.set_span_count(bus_route_item.span_count);
-    proto_bus_route_item.set_stop_from(stop_ids.at(stop_from));
+    if (stop_from.empty()) {
+      proto_bus_route_item.set_is_ride_continuation(true);
+    } else {
+      proto_bus_route_item.set_stop_from(stop_ids.at(stop_from));
+    }
     *proto_transport_router.add_edges() = proto_bus_route_item;
   }
 
@@ -258,6 +405,18 @@ proto_tc::TransportRouter SerializeTransportRouter(const TransportRouter &transp
     }
   }
 
+  proto_transport_router.set_index_version(ROUTER_INDEX_VERSION);
+  const auto &router = transport_router.GetRouter();
+  if (const auto *ch_router = get_if<TransportRouter::ContractionHierarchyRouter>(&router)) {
+    *proto_transport_router.mutable_contraction_hierarchy() =
+        SerializeContractionHierarchy(ch_router->GetContractionHierarchy());
+  }
+  if (const auto *all_pairs_router = get_if<TransportRouter::AllPairsRouter>(&router)) {
+    if (auto proto_all_pairs_routes = SerializeAllPairsRoutes(all_pairs_router->GetRoutesInternalData())) {
+      *proto_transport_router.mutable_all_pairs_routes() = std::move(*proto_all_pairs_routes);
+    }
+  }
+
   return proto_transport_router;
 }
 
@@ -268,21 +427,28 @@ TransportRouter DeserializeTransportRouter(const proto_tc::TransportRouter &prot
       static_cast<int>(proto_transport_router.routing_settings().bus_wait_time());
   routing_settings.bus_velocity =
       static_cast<int>(proto_transport_router.routing_settings().bus_velocity());
+  routing_settings.router_type =
+      DeserializeRouterType(proto_transport_router.routing_settings().router_type());
+  routing_settings.graph_model =
+      DeserializeGraphModel(proto_transport_router.routing_settings().graph_model());
 
   const auto id_stops = GetSortedUnorderedMapKeys(catalogue.GetAllStops());
-  TransportRouter::Graph graph(proto_transport_router.graph().vertex_count());
+  vector<graph::Edge<double>> graph_edges;
+  graph_edges.reserve(proto_transport_router.graph().edges_size());
   TransportRouter::Edges router_edges;
   router_edges.reserve(proto_transport_router.edges_size());
   for (int id = 0; id < proto_transport_router.edges_size(); ++id) {
     const auto &proto_graph_edge = proto_transport_router.graph().edges(id);
-    graph.AddEdge({proto_graph_edge.from(), proto_graph_edge.to(), proto_graph_edge.weight()});
+    graph_edges.push_back({proto_graph_edge.from(), proto_graph_edge.to(), proto_graph_edge.weight()});
 
     const auto &proto_router_edge = proto_transport_router.edges(id);
     router_edges.emplace(id, make_pair(BusRouteItem(
                                            proto_router_edge.time(),
                                            proto_router_edge.bus(),
                                            static_cast<int>(proto_router_edge.span_count())),
-                                       id_stops.at(static_cast<int>(proto_router_edge.stop_from()))));
+                                       proto_router_edge.is_ride_continuation()
+                                       ? string_view{}
+                                       : id_stops.at(static_cast<int>(proto_router_edge.stop_from()))));
   }
 
   TransportRouter::Vertexes router_vertexes;
@@ -292,33 +458,67 @@ TransportRouter DeserializeTransportRouter(const proto_tc::TransportRouter &prot
                             proto_router_vertex.vertex());
   }
 
+  TransportRouter::Graph graph(proto_transport_router.graph().vertex_count(), std::move(graph_edges));
+
+  // Индекс другой версии или не подходящий к графу не используется, маршрутизатор строится по графу заново
+  TransportRouter::RouterIndex router_index;
+  if (proto_transport_router.index_version() == ROUTER_INDEX_VERSION) {
+    if (proto_transport_router.has_contraction_hierarchy()) {
+      auto contraction_hierarchy = DeserializeContractionHierarchy(proto_transport_router.contraction_hierarchy());
+      if (graph::IsValidContractionHierarchy(contraction_hierarchy, graph)) {
+        router_index = std::move(contraction_hierarchy);
+      }
+    } else if (proto_transport_router.has_all_pairs_routes()) {
+      auto all_pairs_routes = DeserializeAllPairsRoutes(proto_transport_router.all_pairs_routes(),
+                                                        proto_transport_router.graph().vertex_count());
+      if (all_pairs_routes && graph::IsValidAllPairsRoutes(*all_pairs_routes, graph)) {
+        router_index = std::move(*all_pairs_routes);
+      }
+    }
+  }
+
   return {catalogue,
           routing_settings,
           std::move(graph),
           std::move(router_vertexes),
-          std::move(router_edges)};
+          std::move(router_edges),
+          std::move(router_index)};
 }
 
 void Serialize(const SerializationSettings &settings,
                const TransportCatalogue &catalogue,
                const RenderSettings &render_settings,
                const TransportRouter &transport_router) {
+  optional<string> rendered_map;
+  if (settings.prerender_map) {
+    rendered_map = MapRenderer(render_settings).RenderMapToString(catalogue.GetAllBuses(), catalogue.GetStops());
+  }
+  if (settings.format == DatabaseFormat::FLAT) {
+    SerializeFlat(settings.db_path, catalogue, render_settings, transport_router, rendered_map);
+    return;
+  }
   proto_tc::TransportCatalogue proto_catalogue;
   *proto_catalogue.mutable_data() = SerializeTransportCatalogue(catalogue);
   *proto_catalogue.mutable_render_settings() = SerializeRenderSettings(render_settings);
   *proto_catalogue.mutable_router() = SerializeTransportRouter(transport_router, catalogue);
+  if (rendered_map) {
+    proto_catalogue.mutable_rendered_map()->set_svg(std::move(*rendered_map));
+  }
   ofstream output(settings.db_path, ios::binary);
   proto_catalogue.SerializeToOstream(&output);
 }
 
-pair<RenderSettings, TransportRouter> Deserialize(const SerializationSettings &settings,
-                                                  TransportCatalogue &catalogue) {
+Database Deserialize(const SerializationSettings &settings, TransportCatalogue &catalogue) {
+  if (IsFlatDatabase(settings.db_path)) {
+    return DeserializeFlat(settings.db_path, catalogue);
+  }
   ifstream input(settings.db_path, ios::binary);
   proto_tc::TransportCatalogue proto_catalogue;
   proto_catalogue.ParseFromIstream(&input);
   DeserializeTransportCatalogue(catalogue, proto_catalogue.data());
   return {DeserializeRenderSettings(proto_catalogue.render_settings()),
-          DeserializeTransportRouter(proto_catalogue.router(), catalogue)};
+          DeserializeTransportRouter(proto_catalogue.router(), catalogue),
+          proto_catalogue.has_rendered_map() ? optional<string>(proto_catalogue.rendered_map().svg()) : nullopt};
 }
 
 }
@@ -5,22 +5,45 @@
 #include "transport_router.h"
 #include <transport_catalogue.pb.h>
 #include <transport_router.pb.h>
+#include <map_renderer.pb.h>
 
 #include <filesystem>
+#include <optional>
+#include <string>
 
 namespace serialization {
 
+// PROTOBUF - одно сообщение protobuf, FLAT - плоские массивы, которые читаются через mmap и загружаются быстрее
+enum class DatabaseFormat { PROTOBUF, FLAT };
+
+// Таблица кратчайших путей между всеми парами вершин растёт как V², а сообщение protobuf ограничено 2 ГБ,
+// поэтому большие таблицы не сохраняются ни в одном из форматов и строятся заново при загрузке
+const size_t MAX_SERIALIZED_ALL_PAIRS_ROUTES = size_t{1} << 26;
+
 struct SerializationSettings {
   std::filesystem::path db_path;
+  DatabaseFormat format = DatabaseFormat::PROTOBUF;
+  // Сохранить в базу готовый текст карты, чтобы запросы Map не отрисовывали её заново
+  bool prerender_map = false;
+};
+
+struct Database {
+  renderer::RenderSettings render_settings;
+  routing::TransportRouter router;
+  // Карта, отрисованная при создании базы, если она была сохранена
+  std::optional<std::string> rendered_map;
 };
 
+proto_tc::RenderSettings SerializeRenderSettings(const renderer::RenderSettings &render_settings);
+
+renderer::RenderSettings DeserializeRenderSettings(const proto_tc::RenderSettings &proto_settings);
+
 void Serialize(const SerializationSettings &settings,
                const transport_catalogue::TransportCatalogue &catalogue,
                const renderer::RenderSettings &render_settings,
                const routing::TransportRouter &transport_router);
 
-std::pair<renderer::RenderSettings,
-          routing::TransportRouter> Deserialize(const SerializationSettings &settings,
-                                                transport_catalogue::TransportCatalogue &catalogue);
+// Формат файла определяется по его содержимому, settings.format не учитывается
+Database Deserialize(const SerializationSettings &settings, transport_catalogue::TransportCatalogue &catalogue);
 
 }
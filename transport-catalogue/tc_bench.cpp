@@ -0,0 +1,345 @@
+#include "city_generator.h"
+#include "json.h"
+#include "json_reader.h"
+#include "request_handler.h"
+#include "serialization.h"
+#include "transport_router.h"
+
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+using namespace std;
+
+using namespace city_generator;
+using namespace json;
+using namespace renderer;
+using namespace request;
+using namespace routing;
+using namespace serialization;
+using namespace transport_catalogue;
+
+namespace {
+
+struct BenchParameters {
+  CityParameters city;
+  size_t request_count = 10'000;
+  // Маршрутизатор, который сохраняется в базу и отвечает на запросы Route.
+  // Предподсчёт иерархии сжатия и всех кратчайших путей на больших сетях долгий, поэтому по умолчанию - Дейкстра
+  RoutingSettings routing_settings{40, 6};
+};
+
+// Результаты этапов в порядке выполнения, выводятся одним документом JSON
+class BenchResults {
+ public:
+  template<typename F>
+  auto Measure(const string &stage, size_t count, F f) {
+    const auto start = chrono::steady_clock::now();
+    if constexpr (is_void_v<invoke_result_t<F>>) {
+      f();
+      Add(stage, count, chrono::steady_clock::now() - start);
+    } else {
+      auto result = f();
+      Add(stage, count, chrono::steady_clock::now() - start);
+      return result;
+    }
+  }
+
+  void SetCounter(const string &name, size_t value) {
+    counters_[name] = static_cast<int>(value);
+  }
+
+  [[nodiscard]] Array GetResults() const {
+    return results_;
+  }
+
+  [[nodiscard]] Dict GetCounters() const {
+    return counters_;
+  }
+
+ private:
+  Array results_;
+  Dict counters_;
+
+  void Add(const string &stage, size_t count, chrono::steady_clock::duration duration) {
+    const double total_ms = chrono::duration<double, milli>(duration).count();
+    results_.emplace_back(Dict{{"stage"s, stage},
+                               {"count"s, static_cast<int>(count)},
+                               {"total_ms"s, total_ms},
+                               {"mean_us"s, count > 0 ? total_ms * 1000. / static_cast<double>(count) : 0.}});
+  }
+};
+
+void PrintUsage(ostream &stream = cerr) {
+  stream << "Usage: tc_bench [--stops=N] [--buses=N] [--min-route-length=N] [--max-route-length=N]\n"
+            "                [--distance-density=X] [--roundtrip-share=X] [--seed=N] [--requests=N]\n"
+            "                [--router=dijkstra|all_pairs|contraction_hierarchy] [--graph-model=stop_pairs|ride_vertices]\n"sv;
+}
+
+const string &GetRouterName(RouterType router_type) {
+  static const string names[] = {"dijkstra"s, "all_pairs"s, "contraction_hierarchy"s};
+  return names[static_cast<size_t>(router_type)];
+}
+
+const string &GetGraphModelName(GraphModel graph_model) {
+  static const string names[] = {"stop_pairs"s, "ride_vertices"s};
+  return names[static_cast<size_t>(graph_model)];
+}
+
+BenchParameters ParseArguments(int argc, char *argv[]) {
+  BenchParameters parameters;
+  for (int i = 1; i < argc; ++i) {
+    const string_view argument(argv[i]);
+    const auto separator = argument.find('=');
+    if (separator == string_view::npos) {
+      throw invalid_argument("Unknown argument: "s + string(argument));
+    }
+    const auto name = argument.substr(0, separator);
+    const string value(argument.substr(separator + 1));
+    if (name == "--stops"sv) {
+      parameters.city.stop_count = stoul(value);
+    } else if (name == "--buses"sv) {
+      parameters.city.bus_count = stoul(value);
+    } else if (name == "--min-route-length"sv) {
+      parameters.city.min_route_length = stoul(value);
+    } else if (name == "--max-route-length"sv) {
+      parameters.city.max_route_length = stoul(value);
+    } else if (name == "--distance-density"sv) {
+      parameters.city.distance_density = stod(value);
+    } else if (name == "--roundtrip-share"sv) {
+      parameters.city.roundtrip_share = stod(value);
+    } else if (name == "--seed"sv) {
+      parameters.city.seed = static_cast<uint32_t>(stoul(value));
+    } else if (name == "--requests"sv) {
+      parameters.request_count = stoul(value);
+    } else if (name == "--router"sv) {
+      if (value == GetRouterName(RouterType::DIJKSTRA)) {
+        parameters.routing_settings.router_type = RouterType::DIJKSTRA;
+      } else if (value == GetRouterName(RouterType::ALL_PAIRS)) {
+        parameters.routing_settings.router_type = RouterType::ALL_PAIRS;
+      } else if (value == GetRouterName(RouterType::CONTRACTION_HIERARCHY)) {
+        parameters.routing_settings.router_type = RouterType::CONTRACTION_HIERARCHY;
+      } else {
+        throw invalid_argument("Unknown router type: "s + value);
+      }
+    } else if (name == "--graph-model"sv) {
+      if (value == GetGraphModelName(GraphModel::STOP_PAIRS)) {
+        parameters.routing_settings.graph_model = GraphModel::STOP_PAIRS;
+      } else if (value == GetGraphModelName(GraphModel::RIDE_VERTICES)) {
+        parameters.routing_settings.graph_model = GraphModel::RIDE_VERTICES;
+      } else {
+        throw invalid_argument("Unknown graph model: "s + value);
+      }
+    } else {
+      throw invalid_argument("Unknown argument: "s + string(argument));
+    }
+  }
+  return parameters;
+}
+
+Dict GetParametersJson(const BenchParameters &parameters) {
+  return {{"stops"s, static_cast<int>(parameters.city.stop_count)},
+          {"buses"s, static_cast<int>(parameters.city.bus_count)},
+          {"min_route_length"s, static_cast<int>(parameters.city.min_route_length)},
+          {"max_route_length"s, static_cast<int>(parameters.city.max_route_length)},
+          {"distance_density"s, parameters.city.distance_density},
+          {"roundtrip_share"s, parameters.city.roundtrip_share},
+          {"seed"s, static_cast<int>(parameters.city.seed)},
+          {"requests"s, static_cast<int>(parameters.request_count)},
+          {"router"s, GetRouterName(parameters.routing_settings.router_type)},
+          {"graph_model"s, GetGraphModelName(parameters.routing_settings.graph_model)}};
+}
+
+RenderSettings GetRenderSettings() {
+  return {1200, 1200, 50, 5, 14, 20, {7, 15}, 20, {7, -3},
+          svg::Rgba{255, 255, 255, 0.85}, 3,
+          {"green"s, svg::Rgb{255, 160, 0}, "red"s}};
+}
+
+string ToString(const Node &node) {
+  ostringstream out;
+  Print(Document{node}, out);
+  return out.str();
+}
+
+Dict GetRenderSettingsJson() {
+  return {{"width"s, 1200}, {"height"s, 1200}, {"padding"s, 50}, {"stop_radius"s, 5}, {"line_width"s, 14},
+          {"bus_label_font_size"s, 20}, {"bus_label_offset"s, Array{7, 15}},
+          {"stop_label_font_size"s, 20}, {"stop_label_offset"s, Array{7, -3}},
+          {"underlayer_color"s, Array{255, 255, 255, 0.85}}, {"underlayer_width"s, 3},
+          {"color_palette"s, Array{"green"s, Array{255, 160, 0}, "red"s}}};
+}
+
+// Запросы одного типа отвечают так же, как ProcessRequests, но без вывода
+// Запросы Route выполняются дважды: с пустым и с заполненным кэшем маршрутов.
+// Статистика кэша выводится в счётчиках
+void MeasureStatRequests(BenchResults &results, const QuerySnapshot &snapshot, const Array &requests) {
+  vector<Request> bus_requests;
+  vector<Request> stop_requests;
+  vector<Request> route_requests;
+  size_t map_count = 0;
+  for (const auto &request : JsonReader::GetTransportCatalogueRequests(requests)) {
+    if (request.type == JsonReader::BUS) {
+      bus_requests.push_back(request);
+    } else if (request.type == JsonReader::STOP) {
+      stop_requests.push_back(request);
+    } else if (request.type == JsonReader::ROUTE) {
+      route_requests.push_back(request);
+    } else if (request.type == JsonReader::MAP) {
+      ++map_count;
+    }
+  }
+  results.Measure("stat_bus"s, bus_requests.size(), [&] {
+    for (const auto &request : bus_requests) {
+      JsonReader::GetBusStatJson(request.id, snapshot.GetRouteStat(request.name));
+    }
+  });
+  results.Measure("stat_stop"s, stop_requests.size(), [&] {
+    for (const auto &request : stop_requests) {
+      JsonReader::GetStopStatJson(request.id, snapshot.GetBusesThroughStop(request.name));
+    }
+  });
+  results.Measure("stat_route"s, route_requests.size(), [&] {
+    for (const auto &request : route_requests) {
+      JsonReader::GetRouteStatJson(request.id, snapshot.BuildRoute(request.from, request.to));
+    }
+  });
+  results.Measure("stat_route_cached"s, route_requests.size(), [&] {
+    for (const auto &request : route_requests) {
+      JsonReader::GetRouteStatJson(request.id, snapshot.BuildRoute(request.from, request.to));
+    }
+  });
+  const auto route_cache_stats = snapshot.GetRouteCacheStats();
+  results.SetCounter("route_cache_hits"s, route_cache_stats.hits);
+  results.SetCounter("route_cache_misses"s, route_cache_stats.misses);
+  results.Measure("stat_map_render"s, map_count, [&] {
+    for (size_t i = 0; i < map_count; ++i) {
+      ostringstream buffer;
+      snapshot.RenderMap().Render(buffer);
+      JsonReader::GetMapStatJson(static_cast<int>(i), buffer.str());
+    }
+  });
+}
+
+BenchResults RunBench(const BenchParameters &parameters) {
+  BenchResults results;
+  const auto base_requests = results.Measure("generate_city"s, parameters.city.stop_count, [&] {
+    return GenerateBaseRequests(parameters.city);
+  });
+  const auto stat_requests = GenerateStatRequests(parameters.city, parameters.request_count);
+
+  const auto db_path = filesystem::temp_directory_path() / "tc_bench.db";
+  const auto flat_db_path = filesystem::temp_directory_path() / "tc_bench_flat.db";
+  const Dict serialization_settings{{"file"s, db_path.string()}};
+  const string make_base_input = ToString(Dict{
+      {"serialization_settings"s, serialization_settings},
+      {"routing_settings"s, Dict{{"bus_velocity"s, parameters.routing_settings.bus_velocity},
+                                 {"bus_wait_time"s, parameters.routing_settings.bus_wait_time},
+                                 {"router"s, GetRouterName(parameters.routing_settings.router_type)},
+                                 {"graph_model"s, GetGraphModelName(parameters.routing_settings.graph_model)}}},
+      {"render_settings"s, GetRenderSettingsJson()},
+      {"base_requests"s, base_requests}});
+  const string process_requests_input = ToString(Dict{
+      {"serialization_settings"s, serialization_settings},
+      {"execution_settings"s, Dict{{"route_cache_size"s, 0}}},
+      {"stat_requests"s, stat_requests}});
+
+  const auto parsed = results.Measure("parse_make_base"s, make_base_input.size(), [&] {
+    return Load(string_view(make_base_input));
+  });
+  const auto &parsed_requests = parsed.GetRoot().AsMap().at("base_requests"s).AsArray();
+  Array stop_requests;
+  Array bus_requests;
+  for (const auto &request : parsed_requests) {
+    (request.AsMap().at("type"s) == JsonReader::STOP ? stop_requests : bus_requests).push_back(request);
+  }
+
+  TransportCatalogue catalogue;
+  JsonReader json_reader(catalogue);
+  results.Measure("add_stops_and_distances"s, stop_requests.size(), [&] {
+    json_reader.AddTransportCatalogueData(stop_requests);
+  });
+  results.Measure("add_buses"s, bus_requests.size(), [&] {
+    json_reader.AddTransportCatalogueData(bus_requests);
+  });
+
+  // У маршрутизатора Дейкстры нет предподсчёта, время его создания - время построения графа
+  results.Measure("build_graph"s, catalogue.GetBusCount(), [&] {
+    return TransportRouter(catalogue, RoutingSettings{40, 6, RouterType::DIJKSTRA});
+  });
+  results.Measure("build_graph_ride_vertices"s, catalogue.GetBusCount(), [&] {
+    return TransportRouter(catalogue, RoutingSettings{40, 6, RouterType::DIJKSTRA, GraphModel::RIDE_VERTICES});
+  });
+  const auto router = results.Measure("build_router"s, catalogue.GetStopCount(), [&] {
+    return TransportRouter(catalogue, parameters.routing_settings);
+  });
+
+  const auto render_settings = GetRenderSettings();
+  results.Measure("serialize_protobuf"s, 1, [&] {
+    Serialize({db_path, DatabaseFormat::PROTOBUF}, catalogue, render_settings, router);
+  });
+  results.Measure("serialize_flat"s, 1, [&] {
+    Serialize({flat_db_path, DatabaseFormat::FLAT}, catalogue, render_settings, router);
+  });
+  {
+    TransportCatalogue flat_catalogue;
+    results.Measure("deserialize_flat"s, 1, [&] {
+      return Deserialize({flat_db_path}, flat_catalogue);
+    });
+  }
+  TransportCatalogue deserialized_catalogue;
+  auto [deserialized_render_settings, deserialized_router, rendered_map] =
+      results.Measure("deserialize_protobuf"s, 1, [&] {
+        return Deserialize({db_path}, deserialized_catalogue);
+      });
+
+  const QuerySnapshot snapshot(deserialized_catalogue,
+                               std::move(deserialized_render_settings),
+                               std::move(deserialized_router),
+                               nullopt,
+                               ExecutionSettings{}.route_cache_size);
+  MeasureStatRequests(results, snapshot, stat_requests);
+
+  // Весь make_base и process_requests целиком, включая разбор и вывод
+  results.Measure("make_base"s, base_requests.size(), [&] {
+    TransportCatalogue make_base_catalogue;
+    RequestHandler request_handler(make_base_catalogue);
+    istringstream input(make_base_input);
+    request_handler.ProcessMakeBaseRequest(input);
+  });
+  results.Measure("process_requests"s, stat_requests.size(), [&] {
+    TransportCatalogue process_catalogue;
+    RequestHandler request_handler(process_catalogue);
+    istringstream input(process_requests_input);
+    ostringstream output;
+    request_handler.ProcessRequests(input, output);
+  });
+
+  filesystem::remove(db_path);
+  filesystem::remove(flat_db_path);
+  return results;
+}
+
+}
+
+int main(int argc, char *argv[]) {
+  BenchParameters parameters;
+  try {
+    parameters = ParseArguments(argc, argv);
+  } catch (const exception &e) {
+    cerr << e.what() << '\n';
+    PrintUsage();
+    return 1;
+  }
+  const auto results = RunBench(parameters);
+  Print(Document{Dict{{"parameters"s, GetParametersJson(parameters)},
+                      {"results"s, results.GetResults()},
+                      {"counters"s, results.GetCounters()}}},
+        cout);
+  cout << endl;
+  return 0;
+}
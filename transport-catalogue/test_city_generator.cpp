@@ -0,0 +1,75 @@
+#include "testing_library.h"
+#include "city_generator.h"
+#include "json_reader.h"
+#include "transport_catalogue.h"
+
+#include <string>
+
+using namespace std;
+
+using namespace city_generator;
+using namespace json;
+using namespace transport_catalogue;
+using namespace request;
+
+namespace {
+
+CityParameters GetSmallCity() {
+  CityParameters parameters;
+  parameters.stop_count = 50;
+  parameters.bus_count = 10;
+  parameters.min_route_length = 2;
+  parameters.max_route_length = 8;
+  parameters.distance_density = 1.;
+  return parameters;
+}
+
+void TestDeterminism() {
+  const auto parameters = GetSmallCity();
+  ASSERT(GenerateBaseRequests(parameters) == GenerateBaseRequests(parameters));
+  ASSERT(GenerateStatRequests(parameters, 200) == GenerateStatRequests(parameters, 200));
+
+  auto other_parameters = parameters;
+  ++other_parameters.seed;
+  ASSERT(GenerateBaseRequests(parameters) != GenerateBaseRequests(other_parameters));
+}
+
+void TestGeneratedCityIsValid() {
+  const auto parameters = GetSmallCity();
+  const auto requests = GenerateBaseRequests(parameters);
+  ASSERT_EQUAL(requests.size(), parameters.stop_count + parameters.bus_count);
+
+  // Расстояния известны для всех соседних остановок, иначе AddBus бросит исключение
+  TransportCatalogue catalogue;
+  JsonReader json_reader(catalogue);
+  json_reader.AddTransportCatalogueData(requests);
+  ASSERT_EQUAL(catalogue.GetStopCount(), parameters.stop_count);
+  ASSERT_EQUAL(catalogue.GetBusCount(), parameters.bus_count);
+  for (size_t i = 0; i < parameters.bus_count; ++i) {
+    const auto &bus = catalogue.FindBus(GetBusName(i));
+    ASSERT(bus.stops_on_route.size() >= parameters.min_route_length);
+    if (bus.route_type == detail::RouteType::CIRCULAR) {
+      ASSERT_EQUAL(bus.stops_on_route.front(), bus.stops_on_route.back());
+    }
+    for (size_t j = 1; j < bus.stops_on_route.size(); ++j) {
+      ASSERT(bus.stops_on_route[j] != bus.stops_on_route[j - 1]);
+    }
+  }
+
+  const auto stat_requests = GenerateStatRequests(parameters, 200);
+  ASSERT_EQUAL(stat_requests.size(), 200);
+  for (const auto &request : JsonReader::GetTransportCatalogueRequests(stat_requests)) {
+    if (request.type == JsonReader::BUS) {
+      ASSERT(catalogue.GetRouteStat(request.name).has_value());
+    } else if (request.type == JsonReader::STOP) {
+      ASSERT(catalogue.GetBusesThroughStop(request.name) != nullptr);
+    }
+  }
+}
+
+}
+
+void CityGeneratorRunTest() {
+  TestDeterminism();
+  TestGeneratedCityIsValid();
+}
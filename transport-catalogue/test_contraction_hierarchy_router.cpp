@@ -0,0 +1,183 @@
+#include "testing_library.h"
+#include "contraction_hierarchy_router.h"
+#include "dijkstra_router.h"
+
+#include <random>
+
+using namespace std;
+
+using namespace graph;
+
+namespace {
+
+DirectedWeightedGraph<int> GenerateGraph(size_t vertex_count, size_t edge_count, unsigned seed) {
+  mt19937 generator(seed);
+  uniform_int_distribution<VertexId> vertex_distribution(0, vertex_count - 1);
+  uniform_int_distribution<int> weight_distribution(0, 20);
+  DirectedWeightedGraph<int> graph(vertex_count);
+  for (size_t i = 0; i < edge_count; ++i) {
+    graph.AddEdge({vertex_distribution(generator),
+                   vertex_distribution(generator),
+                   weight_distribution(generator)});
+  }
+  return graph;
+}
+
+template<typename R>
+void AssertSameRoutes(const DirectedWeightedGraph<int> &graph, const R &router) {
+  DijkstraRouter dijkstra_router(graph);
+  for (VertexId from = 0; from < graph.GetVertexCount(); ++from) {
+    for (VertexId to = 0; to < graph.GetVertexCount(); ++to) {
+      const auto expected = dijkstra_router.BuildRoute(from, to);
+      const auto route = router.BuildRoute(from, to);
+      ASSERT_EQUAL(route.has_value(), expected.has_value());
+      if (!route) {
+        continue;
+      }
+      ASSERT_EQUAL(route->weight, expected->weight);
+      VertexId vertex = from;
+      int weight = 0;
+      for (const auto edge_id : route->edges) {
+        const auto &edge = graph.GetEdge(edge_id);
+        ASSERT_EQUAL(edge.from, vertex);
+        vertex = edge.to;
+        weight += edge.weight;
+      }
+      ASSERT_EQUAL(vertex, to);
+      ASSERT_EQUAL(weight, route->weight);
+    }
+  }
+}
+
+void TestBuildRoute() {
+  {
+    DirectedWeightedGraph<int> graph(15);
+    graph.AddEdge(Edge<int>{1, 2, 3});
+    graph.AddEdge(Edge<int>{2, 1, 5});
+    graph.AddEdge(Edge<int>{2, 3, 4});
+    graph.AddEdge(Edge<int>{3, 4, 1});
+    graph.AddEdge(Edge<int>{3, 4, 10});
+    ContractionHierarchyRouter router(graph);
+    const auto route = router.BuildRoute(1, 4);
+    ASSERT_EQUAL(route->weight, 8);
+    ASSERT_EQUAL(route->edges, (vector<EdgeId>{0, 2, 3}));
+  }
+  {
+    DirectedWeightedGraph<int> graph(15);
+    graph.AddEdge(Edge<int>{1, 2, 3});
+    graph.AddEdge(Edge<int>{2, 1, 5});
+    graph.AddEdge(Edge<int>{2, 3, 4});
+    graph.AddEdge(Edge<int>{3, 2, 3});
+    graph.AddEdge(Edge<int>{3, 4, 1});
+    graph.AddEdge(Edge<int>{3, 4, 10});
+    graph.AddEdge(Edge<int>{5, 7, 10});
+    ContractionHierarchyRouter router(graph);
+    ASSERT_EQUAL(router.BuildRoute(3, 1)->weight, 8);
+    ASSERT(!router.BuildRoute(5, 1).has_value());
+    ASSERT_EQUAL(router.BuildRoute(6, 6)->weight, 0);
+    ASSERT(router.BuildRoute(6, 6)->edges.empty());
+  }
+}
+
+void TestSameRoutesAsDijkstraRouter() {
+  for (unsigned seed = 0; seed < 5; ++seed) {
+    const auto graph = GenerateGraph(40, 120, seed);
+    AssertSameRoutes(graph, ContractionHierarchyRouter(graph));
+  }
+}
+
+void TestRestoreFromHierarchy() {
+  const auto graph = GenerateGraph(30, 100, 42);
+  ContractionHierarchyRouter router(graph);
+  ASSERT_EQUAL(router.GetContractionHierarchy().ranks.size(), graph.GetVertexCount());
+  ContractionHierarchyRouter restored_router(graph, router.GetContractionHierarchy());
+  AssertSameRoutes(graph, restored_router);
+}
+
+void TestHierarchyMismatch() {
+  DirectedWeightedGraph<int> graph(3);
+  try {
+    ContractionHierarchyRouter router(graph, ContractionHierarchy<int>{{0, 1}, {}});
+    ASSERT_HINT(false, "invalid_argument is expected"s);
+  } catch (const invalid_argument &) {
+  }
+}
+
+void TestInvalidShortcuts() {
+  DirectedWeightedGraph<int> graph(3);
+  graph.AddEdge(Edge<int>{0, 1, 1});
+  graph.AddEdge(Edge<int>{1, 2, 1});
+  const ContractionHierarchy<int> valid{{2, 0, 1}, {{0, 2, 2, 0, 1}}};
+  ASSERT(IsValidContractionHierarchy(valid, graph));
+  ContractionHierarchyRouter router(graph, valid);
+  ASSERT_EQUAL(router.BuildRoute(0, 2)->weight, 2);
+  ASSERT_EQUAL(router.BuildRoute(0, 2)->edges, (vector<EdgeId>{0, 1}));
+
+  const vector<Shortcut<int>> invalid_shortcuts{{0, 3, 2, 0, 1},
+                                                {5, 2, 2, 0, 1},
+                                                {0, 2, 2, 0, 7},
+                                                // Сокращение не может ссылаться на себя
+                                                {0, 2, 2, 2, 1}};
+  for (const auto &shortcut : invalid_shortcuts) {
+    const ContractionHierarchy<int> hierarchy{{2, 0, 1}, {shortcut}};
+    ASSERT(!IsValidContractionHierarchy(hierarchy, graph));
+    try {
+      ContractionHierarchyRouter invalid_router(graph, hierarchy);
+      ASSERT_HINT(false, "invalid_argument is expected"s);
+    } catch (const invalid_argument &) {
+    }
+  }
+}
+
+void TestInvalidRanks() {
+  DirectedWeightedGraph<int> graph(3);
+  graph.AddEdge(Edge<int>{0, 1, 1});
+  graph.AddEdge(Edge<int>{1, 2, 1});
+  // При равных рангах ребро 0 -> 1 не попало бы в поиск и маршрут 0 -> 2 не нашёлся бы
+  const vector<vector<size_t>> invalid_ranks{{0, 0, 1}, {3, 0, 1}};
+  for (const auto &ranks : invalid_ranks) {
+    const ContractionHierarchy<int> hierarchy{ranks, {}};
+    ASSERT(!IsValidContractionHierarchy(hierarchy, graph));
+    try {
+      ContractionHierarchyRouter invalid_router(graph, hierarchy);
+      ASSERT_HINT(false, "invalid_argument is expected"s);
+    } catch (const invalid_argument &) {
+    }
+  }
+}
+
+void TestUnchainedShortcuts() {
+  DirectedWeightedGraph<int> graph(3);
+  graph.AddEdge(Edge<int>{0, 1, 1});
+  graph.AddEdge(Edge<int>{1, 2, 1});
+  graph.AddEdge(Edge<int>{2, 0, 1});
+  const vector<Shortcut<int>> unchained_shortcuts{// Первое ребро начинается не в начале сокращения
+                                                  {2, 1, 2, 0, 1},
+                                                  // Второе ребро начинается не в конце первого
+                                                  {0, 0, 2, 0, 2},
+                                                  // Второе ребро заканчивается не в конце сокращения
+                                                  {0, 1, 2, 0, 1},
+                                                  // Вес не равен сумме весов рёбер
+                                                  {0, 2, 3, 0, 1}};
+  for (const auto &shortcut : unchained_shortcuts) {
+    const ContractionHierarchy<int> hierarchy{{2, 0, 1}, {shortcut}};
+    ASSERT(!IsValidContractionHierarchy(hierarchy, graph));
+    try {
+      ContractionHierarchyRouter invalid_router(graph, hierarchy);
+      ASSERT_HINT(false, "invalid_argument is expected"s);
+    } catch (const invalid_argument &) {
+    }
+  }
+}
+
+}
+
+void ContractionHierarchyRouterRunTest() {
+  TestBuildRoute();
+  TestSameRoutesAsDijkstraRouter();
+  TestRestoreFromHierarchy();
+  TestHierarchyMismatch();
+  TestInvalidShortcuts();
+  TestInvalidRanks();
+  TestUnchainedShortcuts();
+}
@@ -0,0 +1,175 @@
+#include "testing_library.h"
+#include "dijkstra_router.h"
+#include "router.h"
+
+using namespace std;
+
+using namespace graph;
+
+namespace {
+
+void TestBuildRoute() {
+  {
+    DirectedWeightedGraph<int> graph(15);
+    graph.AddEdge(Edge<int>{1, 2, 3});
+    graph.AddEdge(Edge<int>{2, 1, 5});
+    graph.AddEdge(Edge<int>{2, 3, 4});
+    graph.AddEdge(Edge<int>{3, 4, 1});
+    graph.AddEdge(Edge<int>{3, 4, 10});
+    DijkstraRouter router(graph);
+    const auto route = router.BuildRoute(1, 4);
+    ASSERT_EQUAL(route->weight, 8);
+    ASSERT_EQUAL(route->edges, (vector<EdgeId>{0, 2, 3}));
+  }
+  {
+    DirectedWeightedGraph<int> graph(15);
+    graph.AddEdge(Edge<int>{1, 2, 3});
+    graph.AddEdge(Edge<int>{2, 1, 5});
+    graph.AddEdge(Edge<int>{2, 3, 4});
+    graph.AddEdge(Edge<int>{3, 2, 3});
+    graph.AddEdge(Edge<int>{3, 4, 1});
+    graph.AddEdge(Edge<int>{3, 4, 10});
+    DijkstraRouter router(graph);
+    const auto route = router.BuildRoute(3, 1);
+    ASSERT_EQUAL(route->weight, 8);
+    ASSERT_EQUAL(route->edges, (vector<EdgeId>{3, 1}));
+  }
+  {
+    DirectedWeightedGraph<int> graph(15);
+    graph.AddEdge(Edge<int>{1, 2, 3});
+    graph.AddEdge(Edge<int>{2, 1, 5});
+    graph.AddEdge(Edge<int>{2, 3, 4});
+    graph.AddEdge(Edge<int>{3, 2, 3});
+    graph.AddEdge(Edge<int>{3, 4, 1});
+    graph.AddEdge(Edge<int>{3, 4, 10});
+    graph.AddEdge(Edge<int>{5, 7, 10});
+    DijkstraRouter router(graph);
+    const auto route = router.BuildRoute(5, 1);
+    ASSERT(!route.has_value());
+  }
+  {
+    DirectedWeightedGraph<int> graph(3);
+    graph.AddEdge(Edge<int>{0, 1, 3});
+    DijkstraRouter router(graph);
+    const auto route = router.BuildRoute(2, 2);
+    ASSERT_EQUAL(route->weight, 0);
+    ASSERT(route->edges.empty());
+  }
+}
+
+void TestSameWeightsAsAllPairsRouter() {
+  DirectedWeightedGraph<double> graph(6);
+  graph.AddEdge(Edge<double>{0, 1, 7.});
+  graph.AddEdge(Edge<double>{0, 2, 9.});
+  graph.AddEdge(Edge<double>{0, 5, 14.});
+  graph.AddEdge(Edge<double>{1, 2, 10.});
+  graph.AddEdge(Edge<double>{1, 3, 15.});
+  graph.AddEdge(Edge<double>{2, 3, 11.});
+  graph.AddEdge(Edge<double>{2, 5, 2.});
+  graph.AddEdge(Edge<double>{3, 4, 6.});
+  graph.AddEdge(Edge<double>{5, 4, 9.});
+  graph.AddEdge(Edge<double>{4, 0, 1.5});
+  Router all_pairs_router(graph);
+  DijkstraRouter dijkstra_router(graph);
+  for (VertexId from = 0; from < graph.GetVertexCount(); ++from) {
+    for (VertexId to = 0; to < graph.GetVertexCount(); ++to) {
+      const auto expected = all_pairs_router.BuildRoute(from, to);
+      const auto route = dijkstra_router.BuildRoute(from, to);
+      ASSERT_EQUAL(route.has_value(), expected.has_value());
+      if (route) {
+        ASSERT_EQUAL(route->weight, expected->weight);
+        double weight = 0.;
+        for (const auto edge_id : route->edges) {
+          weight += graph.GetEdge(edge_id).weight;
+        }
+        ASSERT_EQUAL(weight, route->weight);
+      }
+    }
+  }
+}
+
+void TestCsrGraphRoute() {
+  DirectedWeightedGraph<int> graph(5);
+  graph.AddEdge(Edge<int>{0, 1, 3});
+  graph.AddEdge(Edge<int>{1, 2, 4});
+  graph.AddEdge(Edge<int>{0, 2, 9});
+  graph.AddEdge(Edge<int>{2, 4, 1});
+  const CsrGraph csr_graph(graph);
+  DijkstraRouter router(csr_graph);
+  const auto route = router.BuildRoute(0, 4);
+  ASSERT_EQUAL(route->weight, 8);
+  ASSERT_EQUAL(route->edges, (vector<EdgeId>{0, 1, 3}));
+  ASSERT(!router.BuildRoute(4, 0).has_value());
+}
+
+void TestShortestPathTree() {
+  DirectedWeightedGraph<double> graph(7);
+  graph.AddEdge(Edge<double>{0, 1, 7.});
+  graph.AddEdge(Edge<double>{0, 2, 9.});
+  graph.AddEdge(Edge<double>{0, 5, 14.});
+  graph.AddEdge(Edge<double>{1, 2, 10.});
+  graph.AddEdge(Edge<double>{2, 3, 11.});
+  graph.AddEdge(Edge<double>{2, 5, 2.});
+  graph.AddEdge(Edge<double>{3, 4, 6.});
+  graph.AddEdge(Edge<double>{5, 4, 9.});
+  graph.AddEdge(Edge<double>{4, 0, 1.5});
+  const CsrGraph csr_graph(graph);
+  DijkstraRouter router(csr_graph);
+  for (VertexId from = 0; from < csr_graph.GetVertexCount(); ++from) {
+    const auto tree = router.BuildShortestPathTree(from);
+    for (VertexId to = 0; to < csr_graph.GetVertexCount(); ++to) {
+      const auto expected = router.BuildRoute(from, to);
+      const auto route = router.GetRoute(tree, to);
+      ASSERT_EQUAL(route.has_value(), expected.has_value());
+      ASSERT_EQUAL(tree.weights[to].has_value(), expected.has_value());
+      if (route) {
+        ASSERT_EQUAL(route->weight, expected->weight);
+        ASSERT_EQUAL(route->edges, expected->edges);
+      }
+    }
+  }
+  ASSERT(!router.BuildShortestPathTree(6).weights[0].has_value());
+}
+
+void TestBoundedShortestPathTree() {
+  DirectedWeightedGraph<int> graph(5);
+  graph.AddEdge(Edge<int>{0, 1, 3});
+  graph.AddEdge(Edge<int>{1, 2, 4});
+  graph.AddEdge(Edge<int>{0, 2, 9});
+  graph.AddEdge(Edge<int>{2, 3, 1});
+  graph.AddEdge(Edge<int>{3, 4, 5});
+  DijkstraRouter router(graph);
+  const auto full_tree = router.BuildShortestPathTree(0);
+  for (const int max_weight : {0, 3, 7, 8, 12, 13, 100}) {
+    const auto tree = router.BuildShortestPathTree(0, max_weight);
+    for (VertexId vertex = 0; vertex < graph.GetVertexCount(); ++vertex) {
+      if (*full_tree.weights[vertex] <= max_weight) {
+        ASSERT(tree.weights[vertex] == full_tree.weights[vertex]);
+        ASSERT_EQUAL(router.GetRoute(tree, vertex)->edges, router.GetRoute(full_tree, vertex)->edges);
+      } else {
+        ASSERT(!tree.weights[vertex].has_value());
+      }
+    }
+  }
+}
+
+void TestNegativeWeight() {
+  DirectedWeightedGraph<int> graph(2);
+  graph.AddEdge(Edge<int>{0, 1, -1});
+  try {
+    DijkstraRouter router(graph);
+    ASSERT_HINT(false, "domain_error is expected"s);
+  } catch (const domain_error &) {
+  }
+}
+
+}
+
+void DijkstraRouterRunTest() {
+  TestBuildRoute();
+  TestSameWeightsAsAllPairsRouter();
+  TestCsrGraphRoute();
+  TestShortestPathTree();
+  TestBoundedShortestPathTree();
+  TestNegativeWeight();
+}
@@ -0,0 +1,56 @@
+#include "testing_library.h"
+#include "distance_matrix.h"
+
+#include <stdexcept>
+
+using namespace std;
+
+using namespace transport_catalogue::detail;
+
+namespace {
+
+void TestGetDistance() {
+  DistanceMatrix matrix(4, {{0, 1, 3900}, {1, 0, 3700}, {1, 2, 9900}, {1, 1, 100}});
+  ASSERT_EQUAL(matrix.GetStopCount(), 4);
+  ASSERT_EQUAL(matrix.GetDistance(0, 1).value(), 3900);
+  ASSERT_EQUAL(matrix.GetDistance(1, 0).value(), 3700);
+  ASSERT_EQUAL(matrix.GetDistance(1, 2).value(), 9900);
+  ASSERT_EQUAL(matrix.GetDistance(1, 1).value(), 100);
+  ASSERT(!matrix.GetDistance(0, 2).has_value());
+  ASSERT(!matrix.GetDistance(3, 0).has_value());
+  ASSERT(!matrix.GetDistance(10, 0).has_value());
+}
+
+void TestSymmetricFallback() {
+  DistanceMatrix matrix(3, {{2, 0, 500}, {0, 1, 700}});
+  ASSERT_EQUAL(matrix.GetDistance(2, 0).value(), 500);
+  ASSERT_EQUAL(matrix.GetDistance(0, 2).value(), 500);
+  ASSERT_EQUAL(matrix.GetDistance(1, 0).value(), 700);
+  // Прямое и обратное направление для каждой пары
+  ASSERT_EQUAL(matrix.GetDistanceCount(), 4);
+}
+
+void TestEmpty() {
+  DistanceMatrix matrix;
+  ASSERT_EQUAL(matrix.GetStopCount(), 0);
+  ASSERT(!matrix.GetDistance(0, 0).has_value());
+  DistanceMatrix no_distances(2, {});
+  ASSERT(!no_distances.GetDistance(0, 1).has_value());
+}
+
+void TestStopOutOfRange() {
+  try {
+    DistanceMatrix matrix(2, {{0, 2, 100}});
+    ASSERT_HINT(false, "Stop id out of range should throw"s);
+  } catch (const out_of_range &) {
+  }
+}
+
+}
+
+void DistanceMatrixRunTest() {
+  TestGetDistance();
+  TestSymmetricFallback();
+  TestEmpty();
+  TestStopOutOfRange();
+}
@@ -0,0 +1,234 @@
+#include "testing_library.h"
+#include "transport_catalogue.h"
+#include "domain.h"
+#include "geo.h"
+#include "transport_router.h"
+#include "map_renderer.h"
+#include "serialization.h"
+#include "flat_serialization.h"
+
+#include <fstream>
+#include <stdexcept>
+
+using namespace std;
+
+using namespace transport_catalogue;
+using namespace detail;
+using namespace geo;
+using namespace routing;
+using namespace renderer;
+using namespace serialization;
+
+namespace {
+
+void AddCircularAndLinearBuses(TransportCatalogue &tc) {
+  const Coordinates biryulyovo_coords{55.574371, 37.6517};
+  const Coordinates universam_coords{55.587655, 37.645687};
+  const Coordinates rasskazovka_coords{55.595579, 37.605757};
+  const Coordinates tolstopaltsevo_coords{55.611087, 37.20829};
+  const Coordinates marushkino_coords{55.595884, 37.209755};
+  tc.AddStop({"Biryulyovo"s, biryulyovo_coords});
+  tc.AddStop({"Universam"s, universam_coords});
+  tc.AddStop({"Rasskazovka"s, rasskazovka_coords});
+  tc.AddStop({"Tolstopaltsevo"s, tolstopaltsevo_coords});
+  tc.AddStop({"Marushkino"s, marushkino_coords});
+  tc.AddStop({"Lonely"s, {55.6, 37.5}});
+  tc.AddDistance({"Biryulyovo"s, "Universam", 2400});
+  tc.AddDistance({"Rasskazovka"s, "Universam", 5600});
+  tc.AddDistance({"Biryulyovo"s, "Rasskazovka", 7500});
+  tc.AddDistance({"Tolstopaltsevo"s, "Marushkino", 3900});
+  tc.AddDistance({"Marushkino"s, "Tolstopaltsevo", 3000});
+  tc.AddDistance({"Marushkino"s, "Rasskazovka", 9900});
+  tc.AddDistance({"Marushkino"s, "Marushkino", 100});
+  tc.AddBus({"828"s, {"Biryulyovo"sv, "Universam"sv, "Rasskazovka"sv, "Biryulyovo"sv},
+             RouteType::CIRCULAR});
+  tc.AddBus({"750"s, {"Tolstopaltsevo"sv, "Marushkino"sv, "Marushkino"sv, "Rasskazovka"sv},
+             RouteType::LINEAR});
+}
+
+RenderSettings GetRenderSettings() {
+  return {200, 200, 30, 5, 14, 20, {7, 15}, 20, {7, -3},
+          svg::Rgba{255, 254, 253, 0.85}, 3,
+          {"green"s, svg::Rgb{255, 160, 0}, "red"s}};
+}
+
+void CheckSameRoutes(const TransportCatalogue &tc, const TransportRouter &tr, const TransportRouter &other_tr) {
+  for (const auto &[from, _] : tc.GetAllStops()) {
+    for (const auto &[to, _] : tc.GetAllStops()) {
+      const auto route = tr.BuildRoute(from, to);
+      const auto other_route = other_tr.BuildRoute(from, to);
+      ASSERT_EQUAL(other_route.has_value(), route.has_value());
+      if (!route) {
+        continue;
+      }
+      ASSERT_EQUAL(other_route->total_time, route->total_time);
+      ASSERT_EQUAL(other_route->items.size(), route->items.size());
+      for (size_t i = 0; i < route->items.size(); ++i) {
+        if (const auto *bus_item = get_if<BusRouteItem>(&route->items[i])) {
+          ASSERT_EQUAL(get<BusRouteItem>(other_route->items[i]).bus, bus_item->bus);
+          ASSERT_EQUAL(get<BusRouteItem>(other_route->items[i]).span_count, bus_item->span_count);
+          ASSERT_EQUAL(get<BusRouteItem>(other_route->items[i]).time, bus_item->time);
+        } else {
+          ASSERT_EQUAL(get<WaitRouteItem>(other_route->items[i]).stop, get<WaitRouteItem>(route->items[i]).stop);
+        }
+      }
+    }
+  }
+}
+
+void TestFlatRoundTrip() {
+  TransportCatalogue tc;
+  AddCircularAndLinearBuses(tc);
+  TransportRouter tr(tc, RoutingSettings{30, 2});
+  SerializationSettings serialization_settings{"transport_catalogue_flat.db"s, DatabaseFormat::FLAT};
+  Serialize(serialization_settings, tc, GetRenderSettings(), tr);
+  ASSERT(IsFlatDatabase(serialization_settings.db_path));
+
+  TransportCatalogue deserialized_tc;
+  const auto [render_settings, deserialized_tr, rendered_map] = Deserialize(serialization_settings, deserialized_tc);
+  ASSERT(!rendered_map.has_value());
+  ASSERT_EQUAL(deserialized_tc.GetStopCount(), tc.GetStopCount());
+  ASSERT_EQUAL(deserialized_tc.GetBusCount(), tc.GetBusCount());
+  ASSERT_EQUAL(deserialized_tc.GetAllDistances().size(), tc.GetAllDistances().size());
+  for (const auto &stop : tc.GetStops()) {
+    const auto &deserialized_stop = deserialized_tc.GetStop(stop->id);
+    ASSERT_EQUAL(deserialized_stop.name, stop->name);
+    ASSERT_EQUAL(deserialized_stop.coordinates.lat, stop->coordinates.lat);
+    ASSERT_EQUAL(deserialized_stop.coordinates.lng, stop->coordinates.lng);
+    ASSERT_EQUAL(deserialized_stop.buses_through_stop, stop->buses_through_stop);
+  }
+  for (const auto &bus : tc.GetAllBuses()) {
+    const auto route_stat = tc.GetRouteStat(bus->name);
+    const auto deserialized_route_stat = deserialized_tc.GetRouteStat(bus->name);
+    ASSERT_EQUAL(deserialized_route_stat->stops_count, route_stat->stops_count);
+    ASSERT_EQUAL(deserialized_route_stat->unique_stops_count, route_stat->unique_stops_count);
+    ASSERT_EQUAL(deserialized_route_stat->route_distance, route_stat->route_distance);
+    ASSERT_EQUAL(deserialized_route_stat->curvature, route_stat->curvature);
+    ASSERT_EQUAL(deserialized_tc.FindBus(bus->name).stops_on_route, bus->stops_on_route);
+  }
+  ASSERT_EQUAL(deserialized_tc.GetDistanceBetweenStops("Marushkino"sv, "Tolstopaltsevo"sv).value(), 3000);
+
+  ASSERT_EQUAL(render_settings.GetColorPalette().size(), 3);
+  ASSERT_EQUAL(render_settings.GetWidth(), 200);
+  ASSERT_EQUAL(deserialized_tr.GetRoutingSettings().bus_velocity, tr.GetRoutingSettings().bus_velocity);
+  ASSERT_EQUAL(deserialized_tr.GetGraph().GetEdgeCount(), tr.GetGraph().GetEdgeCount());
+  CheckSameRoutes(tc, tr, deserialized_tr);
+}
+
+void TestFlatRouterVariants() {
+  TransportCatalogue tc;
+  AddCircularAndLinearBuses(tc);
+  SerializationSettings serialization_settings{"transport_catalogue_flat.db"s, DatabaseFormat::FLAT};
+  for (const auto router_type : {RouterType::DIJKSTRA, RouterType::ALL_PAIRS, RouterType::CONTRACTION_HIERARCHY}) {
+    TransportRouter tr(tc, RoutingSettings{30, 2, router_type, GraphModel::RIDE_VERTICES});
+    Serialize(serialization_settings, tc, GetRenderSettings(), tr);
+    TransportCatalogue deserialized_tc;
+    const auto [_, deserialized_tr, rendered_map] = Deserialize(serialization_settings, deserialized_tc);
+    ASSERT(deserialized_tr.GetRoutingSettings().router_type == router_type);
+    ASSERT(deserialized_tr.GetRoutingSettings().graph_model == GraphModel::RIDE_VERTICES);
+    if (router_type == RouterType::CONTRACTION_HIERARCHY) {
+      const auto &hierarchy =
+          get<TransportRouter::ContractionHierarchyRouter>(tr.GetRouter()).GetContractionHierarchy();
+      const auto &deserialized_hierarchy =
+          get<TransportRouter::ContractionHierarchyRouter>(deserialized_tr.GetRouter()).GetContractionHierarchy();
+      ASSERT_EQUAL(deserialized_hierarchy.ranks, hierarchy.ranks);
+      ASSERT_EQUAL(deserialized_hierarchy.shortcuts.size(), hierarchy.shortcuts.size());
+    }
+    if (router_type == RouterType::ALL_PAIRS) {
+      const auto &routes = get<TransportRouter::AllPairsRouter>(tr.GetRouter()).GetRoutesInternalData();
+      const auto &deserialized_routes =
+          get<TransportRouter::AllPairsRouter>(deserialized_tr.GetRouter()).GetRoutesInternalData();
+      ASSERT_EQUAL(deserialized_routes.size(), routes.size());
+    }
+    CheckSameRoutes(tc, tr, deserialized_tr);
+  }
+}
+
+void TestProtobufIsNotFlat() {
+  TransportCatalogue tc;
+  AddCircularAndLinearBuses(tc);
+  TransportRouter tr(tc, RoutingSettings{30, 2});
+  SerializationSettings serialization_settings{"transport_catalogue.db"s};
+  Serialize(serialization_settings, tc, GetRenderSettings(), tr);
+  ASSERT(!IsFlatDatabase(serialization_settings.db_path));
+  ASSERT(!IsFlatDatabase("missing_transport_catalogue.db"s));
+}
+
+// Записывает value по смещению offset от начала секции с номером section
+template<typename T>
+void OverwriteFlatSection(const string &path, size_t section, size_t offset, T value) {
+  fstream file(path, ios::binary | ios::in | ios::out);
+  // Заголовок 16 байт, затем записи секций по 16 байт, начинающиеся со смещения секции
+  uint64_t section_offset = 0;
+  file.seekg(static_cast<streamoff>(16 + section * 16));
+  file.read(reinterpret_cast<char *>(&section_offset), sizeof(section_offset));
+  file.seekp(static_cast<streamoff>(section_offset + offset));
+  file.write(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+void TestCorruptedFlatDatabase() {
+  TransportCatalogue tc;
+  AddCircularAndLinearBuses(tc);
+  TransportRouter tr(tc, RoutingSettings{30, 2});
+  const string path = "transport_catalogue_flat.db"s;
+  SerializeFlat(path, tc, GetRenderSettings(), tr);
+  {
+    // Обрезаем файл посередине таблицы секций
+    ofstream output(path, ios::binary | ios::trunc);
+    output.write("TCFLAT\0\0\1\0\0\0", 12);
+  }
+  TransportCatalogue deserialized_tc;
+  try {
+    DeserializeFlat(path, deserialized_tc);
+    ASSERT_HINT(false, "Truncated database should be rejected"s);
+  } catch (const runtime_error &) {
+  }
+
+  // Идентификатор остановки в пятой секции, секции расстояний, за пределами таблицы остановок
+  SerializeFlat(path, tc, GetRenderSettings(), tr);
+  OverwriteFlatSection(path, 4, 0, uint32_t{1000});
+  TransportCatalogue corrupted_tc;
+  try {
+    DeserializeFlat(path, corrupted_tc);
+    ASSERT_HINT(false, "Unknown stop id should be rejected"s);
+  } catch (const runtime_error &) {
+  }
+
+  // Номер вершины в двенадцатой секции, секции вершин маршрутизатора, за пределами графа
+  SerializeFlat(path, tc, GetRenderSettings(), tr);
+  OverwriteFlatSection(path, 11, 8, uint64_t{1000000});
+  TransportCatalogue corrupted_vertex_tc;
+  try {
+    DeserializeFlat(path, corrupted_vertex_tc);
+    ASSERT_HINT(false, "Unknown vertex should be rejected"s);
+  } catch (const runtime_error &) {
+  }
+
+  // Граница рёбер вершины в девятой секции, секции смещений CSR, за пределами массива рёбер
+  SerializeFlat(path, tc, GetRenderSettings(), tr);
+  OverwriteFlatSection(path, 8, sizeof(uint64_t), uint64_t{1000000});
+  TransportCatalogue corrupted_graph_tc;
+  try {
+    DeserializeFlat(path, corrupted_graph_tc);
+    ASSERT_HINT(false, "Inconsistent graph arrays should be rejected"s);
+  } catch (const runtime_error &) {
+  }
+
+  TransportCatalogue filled_tc;
+  AddCircularAndLinearBuses(filled_tc);
+  SerializeFlat(path, tc, GetRenderSettings(), tr);
+  try {
+    DeserializeFlat(path, filled_tc);
+    ASSERT_HINT(false, "Loading into a filled catalogue should be rejected"s);
+  } catch (const invalid_argument &) {
+  }
+}
+
+}
+
+void FlatSerializationRunTest() {
+  TestFlatRoundTrip();
+  TestFlatRouterVariants();
+  TestProtobufIsNotFlat();
+  TestCorruptedFlatDatabase();
+}
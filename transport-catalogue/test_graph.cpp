@@ -59,6 +59,86 @@ void TestGetIncidentEdges() {
   }
 }
 
+void TestCsrGraph() {
+  DirectedWeightedGraph<int> graph(4);
+  graph.AddEdge(Edge<int>{2, 3, 7});
+  graph.AddEdge(Edge<int>{0, 1, 3});
+  graph.AddEdge(Edge<int>{2, 0, 5});
+  graph.AddEdge(Edge<int>{0, 2, 6});
+  const CsrGraph csr_graph(graph);
+  ASSERT_EQUAL(csr_graph.GetVertexCount(), 4);
+  ASSERT_EQUAL(csr_graph.GetEdgeCount(), 4);
+  for (EdgeId id = 0; id < graph.GetEdgeCount(); ++id) {
+    ASSERT_EQUAL(csr_graph.GetEdge(id).from, graph.GetEdge(id).from);
+    ASSERT_EQUAL(csr_graph.GetEdge(id).to, graph.GetEdge(id).to);
+    ASSERT_EQUAL(csr_graph.GetEdge(id).weight, graph.GetEdge(id).weight);
+  }
+  for (VertexId vertex = 0; vertex < graph.GetVertexCount(); ++vertex) {
+    vector<EdgeId> expected;
+    for (const EdgeId id : graph.GetIncidentEdges(vertex)) {
+      expected.push_back(id);
+    }
+    vector<EdgeId> edges;
+    for (const auto &edge : csr_graph.GetIncidentEdges(vertex)) {
+      ASSERT_EQUAL(edge.to, graph.GetEdge(edge.id).to);
+      ASSERT_EQUAL(edge.weight, graph.GetEdge(edge.id).weight);
+      edges.push_back(edge.id);
+    }
+    ASSERT_EQUAL(edges, expected);
+  }
+}
+
+void TestCsrGraphFromEdges() {
+  const CsrGraph<int> graph(3, {{1, 2, 3}, {0, 1, 4}, {1, 0, 5}});
+  ASSERT_EQUAL(graph.GetVertexCount(), 3);
+  const auto edges = graph.GetIncidentEdges(1);
+  ASSERT_EQUAL(edges.end() - edges.begin(), 2);
+  ASSERT_EQUAL(edges.begin()->id, 0);
+  ASSERT_EQUAL((edges.begin() + 1)->id, 2);
+  ASSERT_EQUAL(graph.GetIncidentEdges(2).end() - graph.GetIncidentEdges(2).begin(), 0);
+  try {
+    CsrGraph<int> invalid_graph(1, {{1, 0, 1}});
+    ASSERT_HINT(false, "out_of_range is expected"s);
+  } catch (const out_of_range &) {
+  }
+}
+
+void TestCsrGraphOverArrays() {
+  const CsrGraph<int> source(3, {{1, 2, 3}, {0, 1, 4}, {1, 0, 5}});
+  const vector<Edge<int>> edges(source.GetEdges().begin(), source.GetEdges().end());
+  const vector<size_t> offsets(source.GetOffsets().begin(), source.GetOffsets().end());
+  const vector<IncidentEdge<int>> incident_edges(source.GetAllIncidentEdges().begin(),
+                                                 source.GetAllIncidentEdges().end());
+  const auto as_range = [](const auto &items) {
+    return ranges::Range{items.data(), items.data() + items.size()};
+  };
+  ASSERT(IsValidCsrGraph(as_range(edges), as_range(offsets), as_range(incident_edges)));
+  const CsrGraph<int> graph(as_range(edges), as_range(offsets), as_range(incident_edges), nullptr);
+  ASSERT_EQUAL(graph.GetVertexCount(), 3);
+  ASSERT_EQUAL(graph.GetEdgeCount(), 3);
+  // Граф не копирует массивы
+  ASSERT(&graph.GetEdge(1) == &edges[1]);
+  ASSERT(graph.GetIncidentEdges(1).begin() == incident_edges.data() + 1);
+
+  vector<vector<size_t>> invalid_offsets{{0, 1, 2}, {0, 2, 1, 3}, {1, 1, 3, 3}};
+  for (const auto &offsets_variant : invalid_offsets) {
+    ASSERT(!IsValidCsrGraph(as_range(edges), as_range(offsets_variant), as_range(incident_edges)));
+  }
+  // Ребро в списке чужой вершины, ребро с другим весом, повтор ребра
+  for (const auto &[position, incident_edge] : vector<pair<size_t, IncidentEdge<int>>>{{0, {0, 2, 3}},
+                                                                                       {1, {0, 2, 4}},
+                                                                                       {2, {0, 2, 3}}}) {
+    auto invalid_incident_edges = incident_edges;
+    invalid_incident_edges[position] = incident_edge;
+    ASSERT(!IsValidCsrGraph(as_range(edges), as_range(offsets), as_range(invalid_incident_edges)));
+    try {
+      CsrGraph<int> invalid_graph(as_range(edges), as_range(offsets), as_range(invalid_incident_edges), nullptr);
+      ASSERT_HINT(false, "invalid_argument is expected"s);
+    } catch (const invalid_argument &) {
+    }
+  }
+}
+
 }
 
 void GraphRunTest() {
@@ -66,4 +146,7 @@ void GraphRunTest() {
   TestGetEdgeCount();
   TestGetVertexCount();
   TestGetIncidentEdges();
+  TestCsrGraph();
+  TestCsrGraphFromEdges();
+  TestCsrGraphOverArrays();
 }
@@ -1,6 +1,8 @@
 #include "testing_library.h"
 #include "json.h"
+#include "json_builder.h"
 
+#include <optional>
 #include <sstream>
 #include <chrono>
 #include <iostream>
@@ -12,9 +14,29 @@ using namespace json;
 
 namespace {
 
+// Разбор из памяти и в плоский документ должен давать тот же документ и те же ошибки, что и разбор из потока
 Document LoadJSON(const string &s) {
+  optional<Document> buffer_doc;
+  try {
+    buffer_doc = Load(string_view(s));
+  } catch (const ParsingError &) {
+  }
+  optional<Node> flat_node;
+  try {
+    flat_node = FlatDocument(s).GetRoot().ToNode();
+  } catch (const ParsingError &) {
+  }
   istringstream strm(s);
-  return Load(strm);
+  try {
+    auto doc = Load(strm);
+    ASSERT(buffer_doc.has_value() && *buffer_doc == doc);
+    ASSERT(flat_node.has_value() && *flat_node == doc.GetRoot());
+    return doc;
+  } catch (const ParsingError &) {
+    ASSERT(!buffer_doc.has_value());
+    ASSERT(!flat_node.has_value());
+    throw;
+  }
 }
 
 string Print(const Node &node) {
@@ -186,6 +208,14 @@ void TestMap() {
              .GetRoot() == dict_node);
 }
 
+void TestPrintCompact() {
+  const Node node{Dict{{"key"s, Array{1, "a\nb"s, Dict{}, Array{}, nullptr}}, {"flag"s, true}}};
+  ostringstream out;
+  PrintCompact(Document{node}, out);
+  ASSERT_EQUAL(out.str(), R"({"flag":true,"key":[1,"a\nb",{},[],null]})"s);
+  ASSERT(LoadJSON(out.str()).GetRoot() == node);
+}
+
 void TestErrorHandling() {
   MustFailToLoad("["s);
   MustFailToLoad("]"s);
@@ -222,6 +252,89 @@ void TestErrorHandling() {
   });
 }
 
+void TestLoadFromBuffer() {
+  // Строки длиннее восьми байт со спецсимволами в разных позициях
+  ASSERT(LoadJSON("\"abcdefghijklmnop\""s).GetRoot() == Node{"abcdefghijklmnop"s});
+  ASSERT(LoadJSON("\"abcdefg\\\"hijklmno\\\\p\""s).GetRoot() == Node{"abcdefg\"hijklmno\\p"s});
+  MustFailToLoad("\"abcdefghij\nklmnop\""s);
+  MustFailToLoad("\"abcdefghijklmnop"s);
+  // Переполнение int даёт double
+  ASSERT(LoadJSON("2147483648"s).GetRoot() == Node{2147483648.});
+  ASSERT(LoadJSON("-2147483648"s).GetRoot().IsInt());
+  MustFailToLoad("1e400"s);
+  MustFailToLoad("-"s);
+  MustFailToLoad("1."s);
+  MustFailToLoad(""s);
+  MustFailToLoad("nulx"s);
+  MustFailToLoad("{\"key\": 1"s);
+}
+
+void TestFlatDocument() {
+  const FlatDocument document("{\"stops\": [\"A\\\"B\", \"C\"], \"id\": 7, \"id\": 8, "
+                              "\"ratio\": 0.5, \"flag\": false, \"none\": null, \"empty\": {}}"s);
+  const auto root = document.GetRoot();
+  ASSERT(root.IsMap());
+  ASSERT_EQUAL(root.GetSize(), 7u);
+  ASSERT_EQUAL(root.At("id"sv).AsInt(), 7);
+  ASSERT_EQUAL(root.At("ratio"sv).AsDouble(), 0.5);
+  ASSERT_EQUAL(root.At("id"sv).AsDouble(), 7.);
+  ASSERT(!root.At("flag"sv).AsBool());
+  ASSERT(root.At("none"sv).IsNull());
+  ASSERT_EQUAL(root.At("empty"sv).GetSize(), 0u);
+  ASSERT(!root.Find("missing"sv).has_value());
+
+  vector<string_view> stops;
+  root.At("stops"sv).ForEachItem([&stops](FlatDocument::NodeRef stop) {
+    stops.push_back(stop.AsString());
+  });
+  ASSERT_EQUAL(stops, (vector<string_view>{"A\"B"sv, "C"sv}));
+
+  vector<string_view> keys;
+  root.ForEachEntry([&keys](string_view key, FlatDocument::NodeRef) { keys.push_back(key); });
+  ASSERT_EQUAL(keys.size(), 7u);
+  ASSERT_EQUAL(keys.back(), "empty"sv);
+
+  MustThrowLogicError([&root] {
+    root.At("id"sv).AsString();
+  });
+  MustThrowLogicError([&root] {
+    root.At("stops"sv).ForEachEntry([](string_view, FlatDocument::NodeRef) {});
+  });
+}
+
+// Собирает дерево по событиям потокового разбора
+class BuildingHandler final : public Handler {
+ public:
+  void StartDict() override { builder_.StartDict(); }
+  void Key(string key) override { builder_.Key(std::move(key)); }
+  void EndDict() override { builder_.EndDict(); }
+  void StartArray() override { builder_.StartArray(); }
+  void EndArray() override { builder_.EndArray(); }
+  void Value(Node value) override { builder_.Value(std::move(value)); }
+
+  Node Build() { return builder_.Build(); }
+
+ private:
+  Builder builder_;
+};
+
+void TestParse() {
+  const string input = "{\"array\": [1, 2.5, \"str\", [], {}], \"null\": null, "
+                       "\"map\": {\"bool\": true, \"nested\": [false]}}"s;
+  istringstream strm(input);
+  BuildingHandler handler;
+  Parse(strm, handler);
+  ASSERT(handler.Build() == LoadJSON(input).GetRoot());
+
+  istringstream broken_strm("[1, 2"s);
+  BuildingHandler broken_handler;
+  try {
+    Parse(broken_strm, broken_handler);
+    ASSERT_HINT(false, "ParsingError is expected"s);
+  } catch (const ParsingError &) {
+  }
+}
+
 void Benchmark() {
   const auto start = chrono::steady_clock::now();
   Array arr;
@@ -254,6 +367,10 @@ void JsonRunTest() {
   TestBool();
   TestArray();
   TestMap();
+  TestPrintCompact();
   TestErrorHandling();
+  TestLoadFromBuffer();
+  TestFlatDocument();
+  TestParse();
   Benchmark();
 }
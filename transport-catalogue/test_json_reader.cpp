@@ -44,109 +44,112 @@ void FillTransportCatalogue(TransportCatalogue &tc) {
   json_reader.AddTransportCatalogueData(json_input.AsArray());
 }
 
+string GetMakeBaseInput() {
+  return "{\n"
+         "      \"serialization_settings\": {\n"
+         "          \"file\": \"transport_catalogue.db\"\n"
+         "      },"
+         "      \"base_requests\": [\n"
+         "          {\n"
+         "              \"is_roundtrip\": true,\n"
+         "              \"name\": \"297\",\n"
+         "              \"stops\": [\n"
+         "                  \"Biryulyovo Zapadnoye\",\n"
+         "                  \"Biryulyovo Tovarnaya\",\n"
+         "                  \"Universam\",\n"
+         "                  \"Biryulyovo Zapadnoye\"\n"
+         "              ],\n"
+         "              \"type\": \"Bus\"\n"
+         "          },\n"
+         "          {\n"
+         "              \"is_roundtrip\": false,\n"
+         "              \"name\": \"635\",\n"
+         "              \"stops\": [\n"
+         "                  \"Biryulyovo Tovarnaya\",\n"
+         "                  \"Universam\",\n"
+         "                  \"Prazhskaya\"\n"
+         "              ],\n"
+         "              \"type\": \"Bus\"\n"
+         "          },\n"
+         "          {\n"
+         "              \"latitude\": 55.574371,\n"
+         "              \"longitude\": 37.6517,\n"
+         "              \"name\": \"Biryulyovo Zapadnoye\",\n"
+         "              \"road_distances\": {\n"
+         "                  \"Biryulyovo Tovarnaya\": 2600\n"
+         "              },\n"
+         "              \"type\": \"Stop\"\n"
+         "          },\n"
+         "          {\n"
+         "              \"latitude\": 55.587655,\n"
+         "              \"longitude\": 37.645687,\n"
+         "              \"name\": \"Universam\",\n"
+         "              \"road_distances\": {\n"
+         "                  \"Biryulyovo Tovarnaya\": 1380,\n"
+         "                  \"Biryulyovo Zapadnoye\": 2500,\n"
+         "                  \"Prazhskaya\": 4650\n"
+         "              },\n"
+         "              \"type\": \"Stop\"\n"
+         "          },\n"
+         "          {\n"
+         "              \"latitude\": 55.592028,\n"
+         "              \"longitude\": 37.653656,\n"
+         "              \"name\": \"Biryulyovo Tovarnaya\",\n"
+         "              \"road_distances\": {\n"
+         "                  \"Universam\": 890\n"
+         "              },\n"
+         "              \"type\": \"Stop\"\n"
+         "          },\n"
+         "          {\n"
+         "              \"latitude\": 55.611717,\n"
+         "              \"longitude\": 37.603938,\n"
+         "              \"name\": \"Prazhskaya\",\n"
+         "              \"road_distances\": {},\n"
+         "              \"type\": \"Stop\"\n"
+         "          }\n"
+         "      ],\n"
+         "      \"render_settings\": {\n"
+         "          \"bus_label_font_size\": 20,\n"
+         "          \"bus_label_offset\": [\n"
+         "              7,\n"
+         "              15\n"
+         "          ],\n"
+         "          \"color_palette\": [\n"
+         "              \"green\",\n"
+         "              [\n"
+         "                  255,\n"
+         "                  160,\n"
+         "                  0\n"
+         "              ],\n"
+         "              \"red\"\n"
+         "          ],\n"
+         "          \"height\": 200,\n"
+         "          \"line_width\": 14,\n"
+         "          \"padding\": 30,\n"
+         "          \"stop_label_font_size\": 20,\n"
+         "          \"stop_label_offset\": [\n"
+         "              7,\n"
+         "              -3\n"
+         "          ],\n"
+         "          \"stop_radius\": 5,\n"
+         "          \"underlayer_color\": [\n"
+         "              255,\n"
+         "              255,\n"
+         "              255,\n"
+         "              0.85\n"
+         "          ],\n"
+         "          \"underlayer_width\": 3,\n"
+         "          \"width\": 200\n"
+         "      },\n"
+         "      \"routing_settings\": {\n"
+         "          \"bus_velocity\": 40,\n"
+         "          \"bus_wait_time\": 6\n"
+         "      }\n"
+         "  }";
+}
+
 void TestGetParsedBaseRequests() {
-  string input = "{\n"
-                 "      \"serialization_settings\": {\n"
-                 "          \"file\": \"transport_catalogue.db\"\n"
-                 "      },"
-                 "      \"base_requests\": [\n"
-                 "          {\n"
-                 "              \"is_roundtrip\": true,\n"
-                 "              \"name\": \"297\",\n"
-                 "              \"stops\": [\n"
-                 "                  \"Biryulyovo Zapadnoye\",\n"
-                 "                  \"Biryulyovo Tovarnaya\",\n"
-                 "                  \"Universam\",\n"
-                 "                  \"Biryulyovo Zapadnoye\"\n"
-                 "              ],\n"
-                 "              \"type\": \"Bus\"\n"
-                 "          },\n"
-                 "          {\n"
-                 "              \"is_roundtrip\": false,\n"
-                 "              \"name\": \"635\",\n"
-                 "              \"stops\": [\n"
-                 "                  \"Biryulyovo Tovarnaya\",\n"
-                 "                  \"Universam\",\n"
-                 "                  \"Prazhskaya\"\n"
-                 "              ],\n"
-                 "              \"type\": \"Bus\"\n"
-                 "          },\n"
-                 "          {\n"
-                 "              \"latitude\": 55.574371,\n"
-                 "              \"longitude\": 37.6517,\n"
-                 "              \"name\": \"Biryulyovo Zapadnoye\",\n"
-                 "              \"road_distances\": {\n"
-                 "                  \"Biryulyovo Tovarnaya\": 2600\n"
-                 "              },\n"
-                 "              \"type\": \"Stop\"\n"
-                 "          },\n"
-                 "          {\n"
-                 "              \"latitude\": 55.587655,\n"
-                 "              \"longitude\": 37.645687,\n"
-                 "              \"name\": \"Universam\",\n"
-                 "              \"road_distances\": {\n"
-                 "                  \"Biryulyovo Tovarnaya\": 1380,\n"
-                 "                  \"Biryulyovo Zapadnoye\": 2500,\n"
-                 "                  \"Prazhskaya\": 4650\n"
-                 "              },\n"
-                 "              \"type\": \"Stop\"\n"
-                 "          },\n"
-                 "          {\n"
-                 "              \"latitude\": 55.592028,\n"
-                 "              \"longitude\": 37.653656,\n"
-                 "              \"name\": \"Biryulyovo Tovarnaya\",\n"
-                 "              \"road_distances\": {\n"
-                 "                  \"Universam\": 890\n"
-                 "              },\n"
-                 "              \"type\": \"Stop\"\n"
-                 "          },\n"
-                 "          {\n"
-                 "              \"latitude\": 55.611717,\n"
-                 "              \"longitude\": 37.603938,\n"
-                 "              \"name\": \"Prazhskaya\",\n"
-                 "              \"road_distances\": {},\n"
-                 "              \"type\": \"Stop\"\n"
-                 "          }\n"
-                 "      ],\n"
-                 "      \"render_settings\": {\n"
-                 "          \"bus_label_font_size\": 20,\n"
-                 "          \"bus_label_offset\": [\n"
-                 "              7,\n"
-                 "              15\n"
-                 "          ],\n"
-                 "          \"color_palette\": [\n"
-                 "              \"green\",\n"
-                 "              [\n"
-                 "                  255,\n"
-                 "                  160,\n"
-                 "                  0\n"
-                 "              ],\n"
-                 "              \"red\"\n"
-                 "          ],\n"
-                 "          \"height\": 200,\n"
-                 "          \"line_width\": 14,\n"
-                 "          \"padding\": 30,\n"
-                 "          \"stop_label_font_size\": 20,\n"
-                 "          \"stop_label_offset\": [\n"
-                 "              7,\n"
-                 "              -3\n"
-                 "          ],\n"
-                 "          \"stop_radius\": 5,\n"
-                 "          \"underlayer_color\": [\n"
-                 "              255,\n"
-                 "              255,\n"
-                 "              255,\n"
-                 "              0.85\n"
-                 "          ],\n"
-                 "          \"underlayer_width\": 3,\n"
-                 "          \"width\": 200\n"
-                 "      },\n"
-                 "      \"routing_settings\": {\n"
-                 "          \"bus_velocity\": 40,\n"
-                 "          \"bus_wait_time\": 6\n"
-                 "      }\n"
-                 "  }";
-  istringstream istream{input};
+  istringstream istream{GetMakeBaseInput()};
   const auto collections = JsonReader::GetParsedBaseRequests(istream);
   ASSERT_EQUAL(collections.base_requests.size(), 6);
   ASSERT_EQUAL(collections.serialization_settings.size(), 1);
@@ -154,6 +157,32 @@ void TestGetParsedBaseRequests() {
   ASSERT_EQUAL(collections.render_settings.size(), 12);
 }
 
+void TestReadBaseRequests() {
+  istringstream tree_istream{GetMakeBaseInput()};
+  TransportCatalogue tree_tc;
+  JsonReader(tree_tc).AddTransportCatalogueData(
+      JsonReader::GetParsedBaseRequests(tree_istream).base_requests);
+
+  istringstream istream{GetMakeBaseInput()};
+  TransportCatalogue tc;
+  const auto settings = JsonReader(tc).ReadBaseRequests(istream);
+  ASSERT_EQUAL(settings.serialization_settings.size(), 1);
+  ASSERT_EQUAL(settings.routing_settings.size(), 2);
+  ASSERT_EQUAL(settings.render_settings.size(), 12);
+  ASSERT_EQUAL(settings.render_settings.at("color_palette"s).AsArray().size(), 3);
+
+  ASSERT_EQUAL(tc.GetStopCount(), tree_tc.GetStopCount());
+  ASSERT_EQUAL(tc.GetAllDistances().size(), tree_tc.GetAllDistances().size());
+  ASSERT_EQUAL(tc.GetBusCount(), tree_tc.GetBusCount());
+  for (const auto bus : tree_tc.GetAllBuses()) {
+    const auto &streamed_bus = tc.FindBus(bus->name);
+    ASSERT_EQUAL(streamed_bus.stops_on_route, bus->stops_on_route);
+    ASSERT_EQUAL(streamed_bus.route_distance, bus->route_distance);
+    ASSERT_EQUAL(streamed_bus.unique_stops_count, bus->unique_stops_count);
+  }
+  ASSERT_EQUAL(tc.FindStop("Universam"s).buses_through_stop, tree_tc.FindStop("Universam"s).buses_through_stop);
+}
+
 void TestGetParsedStatRequests() {
   string input = "{\n"
                  "      \"serialization_settings\": {\n"
@@ -186,13 +215,51 @@ void TestGetParsedStatRequests() {
                  "              \"id\": 5,\n"
                  "              \"to\": \"Prazhskaya\",\n"
                  "              \"type\": \"Route\"\n"
+                 "          },\n"
+                 "          {\n"
+                 "              \"id\": 6,\n"
+                 "              \"stops\": [\"Universam\", \"Prazhskaya\"],\n"
+                 "              \"targets\": [\"Biryulyovo Zapadnoye\"],\n"
+                 "              \"type\": \"RouteMatrix\",\n"
+                 "              \"with_items\": true\n"
+                 "          },\n"
+                 "          {\n"
+                 "              \"from\": \"Universam\",\n"
+                 "              \"id\": 7,\n"
+                 "              \"max_time\": 12.5,\n"
+                 "              \"render_map\": true,\n"
+                 "              \"type\": \"Isochrone\"\n"
                  "          }\n"
                  "      ]\n"
                  "  }";
   istringstream istream{input};
   const auto collections = JsonReader::GetParsedStatRequests(istream);
-  ASSERT_EQUAL(collections.stat_requests.size(), 5);
+  ASSERT_EQUAL(collections.stat_requests.size(), 7);
   ASSERT_EQUAL(collections.serialization_settings.size(), 1);
+
+  istringstream stat_istream{input};
+  const auto stat_requests = JsonReader::ReadStatRequests(stat_istream);
+  ASSERT_EQUAL(stat_requests.serialization_settings.size(), 1);
+  const auto requests = JsonReader::GetTransportCatalogueRequests(collections.stat_requests);
+  ASSERT_EQUAL(stat_requests.requests.size(), requests.size());
+  for (size_t i = 0; i < requests.size(); ++i) {
+    ASSERT_EQUAL(stat_requests.requests[i].id, requests[i].id);
+    ASSERT_EQUAL(stat_requests.requests[i].type, requests[i].type);
+    ASSERT_EQUAL(stat_requests.requests[i].name, requests[i].name);
+    ASSERT_EQUAL(stat_requests.requests[i].from, requests[i].from);
+    ASSERT_EQUAL(stat_requests.requests[i].to, requests[i].to);
+    ASSERT_EQUAL(stat_requests.requests[i].stops, requests[i].stops);
+    ASSERT_EQUAL(stat_requests.requests[i].targets, requests[i].targets);
+    ASSERT_EQUAL(stat_requests.requests[i].with_items, requests[i].with_items);
+    ASSERT_EQUAL(stat_requests.requests[i].max_time, requests[i].max_time);
+    ASSERT_EQUAL(stat_requests.requests[i].render_map, requests[i].render_map);
+  }
+  ASSERT_EQUAL(requests[6].max_time, 12.5);
+  ASSERT(requests[6].render_map);
+  ASSERT_EQUAL(requests[5].stops, (vector<string>{"Universam"s, "Prazhskaya"s}));
+  ASSERT_EQUAL(requests[5].targets, vector<string>{"Biryulyovo Zapadnoye"s});
+  ASSERT(requests[5].with_items);
+  ASSERT(!requests[4].with_items);
 }
 
 void TestAddTransportCatalogueData() {
@@ -328,6 +395,71 @@ void TestGetRoutingSettings() {
   auto map_settings = JsonReader::GetRoutingSettings(routing_settings.AsMap());
   ASSERT_EQUAL(map_settings.bus_velocity, 1000);
   ASSERT_EQUAL(map_settings.bus_wait_time, 6);
+  ASSERT(map_settings.router_type == RouterType::DIJKSTRA);
+
+  string input_all_pairs_settings = "{\n"
+                                    "  \"bus_velocity\": 60,\n"
+                                    "  \"bus_wait_time\": 6,\n"
+                                    "  \"router\": \"all_pairs\"\n"
+                                    "}";
+  istringstream istream_all_pairs_settings{input_all_pairs_settings};
+  const auto all_pairs_settings = Load(istream_all_pairs_settings).GetRoot();
+  ASSERT(JsonReader::GetRoutingSettings(all_pairs_settings.AsMap()).router_type
+             == RouterType::ALL_PAIRS);
+  ASSERT(JsonReader::GetRoutingSettings(all_pairs_settings.AsMap()).graph_model
+             == GraphModel::STOP_PAIRS);
+
+  string input_ride_vertices_settings = "{\n"
+                                        "  \"bus_velocity\": 60,\n"
+                                        "  \"bus_wait_time\": 6,\n"
+                                        "  \"graph_model\": \"ride_vertices\"\n"
+                                        "}";
+  istringstream istream_ride_vertices_settings{input_ride_vertices_settings};
+  const auto ride_vertices_settings = Load(istream_ride_vertices_settings).GetRoot();
+  ASSERT(JsonReader::GetRoutingSettings(ride_vertices_settings.AsMap()).graph_model
+             == GraphModel::RIDE_VERTICES);
+}
+
+void TestGetSerializationSettings() {
+  istringstream istream_settings{"{\"file\": \"transport_catalogue.db\"}"s};
+  const auto settings = JsonReader::GetSerializationSettings(Load(istream_settings).GetRoot().AsMap());
+  ASSERT_EQUAL(settings.db_path.string(), "transport_catalogue.db"s);
+  ASSERT(settings.format == serialization::DatabaseFormat::PROTOBUF);
+
+  istringstream istream_flat_settings{"{\"file\": \"transport_catalogue.db\", \"format\": \"flat\"}"s};
+  const auto flat_settings = JsonReader::GetSerializationSettings(Load(istream_flat_settings).GetRoot().AsMap());
+  ASSERT(flat_settings.format == serialization::DatabaseFormat::FLAT);
+  ASSERT(!flat_settings.prerender_map);
+
+  istringstream istream_prerender_settings{"{\"file\": \"transport_catalogue.db\", \"prerender_map\": true}"s};
+  const auto prerender_settings =
+      JsonReader::GetSerializationSettings(Load(istream_prerender_settings).GetRoot().AsMap());
+  ASSERT(prerender_settings.prerender_map);
+}
+
+void TestGetExecutionSettings() {
+  const auto default_settings = JsonReader::GetExecutionSettings({});
+  ASSERT(default_settings.mode == ExecutionMode::SEQUENTIAL);
+  ASSERT_EQUAL(default_settings.thread_count, 0);
+
+  istringstream istream_settings{"{\"mode\": \"parallel\", \"thread_count\": 4}"s};
+  const auto settings = JsonReader::GetExecutionSettings(Load(istream_settings).GetRoot().AsMap());
+  ASSERT(settings.mode == ExecutionMode::PARALLEL);
+  ASSERT_EQUAL(settings.thread_count, 4);
+  ASSERT_EQUAL(settings.route_cache_size, 4096);
+
+  istringstream istream_cache_settings{"{\"route_cache_size\": 0}"s};
+  ASSERT_EQUAL(JsonReader::GetExecutionSettings(Load(istream_cache_settings).GetRoot().AsMap()).route_cache_size, 0);
+
+  istringstream istream_unknown{"{\"mode\": \"concurrent\"}"s};
+  const auto unknown_settings = Load(istream_unknown).GetRoot().AsMap();
+  bool thrown = false;
+  try {
+    JsonReader::GetExecutionSettings(unknown_settings);
+  } catch (const invalid_argument &) {
+    thrown = true;
+  }
+  ASSERT(thrown);
 }
 
 void TestGetRouteStatJson() {
@@ -352,6 +484,7 @@ void TestGetRouteStatJson() {
 
 void JsonReaderRunTest() {
   TestGetParsedBaseRequests();
+  TestReadBaseRequests();
   TestGetParsedStatRequests();
   TestAddTransportCatalogueData();
   TestGetTransportCatalogueRequests();
@@ -360,5 +493,7 @@ void JsonReaderRunTest() {
   TestGetBusStatJson();
   TestGetStopStatJson();
   TestGetRoutingSettings();
+  TestGetSerializationSettings();
+  TestGetExecutionSettings();
   TestGetRouteStatJson();
 }
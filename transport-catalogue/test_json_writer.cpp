@@ -0,0 +1,78 @@
+#include "testing_library.h"
+#include "json_writer.h"
+
+#include <sstream>
+
+using namespace std;
+using namespace json;
+
+namespace {
+
+string Print(const Node &node) {
+  ostringstream out;
+  Print(Document{node}, out);
+  return out.str();
+}
+
+void TestSameAsPrint() {
+  const Node expected{Array{
+      Dict{{"buses"s, Array{"114"s, "297"s}}, {"request_id"s, 1}},
+      Dict{{"error_message"s, "not found"s}, {"request_id"s, 2}},
+      Array{},
+      Dict{},
+      Array{Array{1, 2.5}, "\"quoted\"\n"s, nullptr, true}}};
+
+  ostringstream out;
+  Writer writer(out);
+  writer.StartArray()
+      .StartDict()
+      .Key("buses"sv).StartArray().Value("114"s).Value("297"s).EndArray()
+      .Key("request_id"sv).Value(1)
+      .EndDict()
+      .Value(Dict{{"error_message"s, "not found"s}, {"request_id"s, 2}})
+      .StartArray().EndArray()
+      .StartDict().EndDict()
+      .StartArray()
+      .Value(Array{1, 2.5})
+      .Value("\"quoted\"\n"s)
+      .Value(nullptr)
+      .Value(true)
+      .EndArray()
+      .EndArray();
+  ASSERT_EQUAL(out.str(), Print(expected));
+}
+
+void TestScalarRoot() {
+  ostringstream out;
+  Writer(out).Value(42);
+  ASSERT_EQUAL(out.str(), Print(Node{42}));
+}
+
+template<typename Fn>
+void MustThrowLogicError(Fn fn) {
+  try {
+    ostringstream out;
+    Writer writer(out);
+    fn(writer);
+    ASSERT_HINT(false, "logic_error is expected"s);
+  } catch (const logic_error &) {
+  }
+}
+
+void TestInvalidWriting() {
+  MustThrowLogicError([](Writer &writer) { writer.EndArray(); });
+  MustThrowLogicError([](Writer &writer) { writer.Key("key"sv); });
+  MustThrowLogicError([](Writer &writer) { writer.StartDict().Value(1); });
+  MustThrowLogicError([](Writer &writer) { writer.StartDict().Key("key"sv).EndDict(); });
+  MustThrowLogicError([](Writer &writer) { writer.StartArray().Key("key"sv); });
+  MustThrowLogicError([](Writer &writer) { writer.StartArray().EndDict(); });
+  MustThrowLogicError([](Writer &writer) { writer.Value(1).Value(2); });
+}
+
+}
+
+void JsonWriterRunTest() {
+  TestSameAsPrint();
+  TestScalarRoot();
+  TestInvalidWriting();
+}
@@ -0,0 +1,91 @@
+#include "testing_library.h"
+#include "lru_cache.h"
+
+#include <string>
+#include <thread>
+
+using namespace std;
+
+using namespace concurrency;
+
+namespace {
+
+void TestFindAndInsert() {
+  LruCache<int, string> cache(2, 1);
+  ASSERT(!cache.Find(1).has_value());
+  cache.Insert(1, "one"s);
+  cache.Insert(2, "two"s);
+  ASSERT(cache.Find(1) == optional<string>("one"s));
+  // 2 использовался давнее всех и вытесняется
+  cache.Insert(3, "three"s);
+  ASSERT_EQUAL(cache.GetSize(), 2);
+  ASSERT(!cache.Find(2).has_value());
+  ASSERT(cache.Find(1) == optional<string>("one"s));
+  ASSERT(cache.Find(3) == optional<string>("three"s));
+
+  cache.Insert(3, "three again"s);
+  ASSERT_EQUAL(cache.GetSize(), 2);
+  ASSERT(cache.Find(3) == optional<string>("three again"s));
+
+  const auto stats = cache.GetStats();
+  ASSERT_EQUAL(stats.hits, 4);
+  ASSERT_EQUAL(stats.misses, 2);
+}
+
+void TestGetOrCompute() {
+  LruCache<int, int> cache(10);
+  int computed = 0;
+  const auto square = [&computed](int value) {
+    return [&computed, value] {
+      ++computed;
+      return value * value;
+    };
+  };
+  ASSERT_EQUAL(cache.GetOrCompute(3, square(3)), 9);
+  ASSERT_EQUAL(cache.GetOrCompute(3, square(3)), 9);
+  ASSERT_EQUAL(cache.GetOrCompute(4, square(4)), 16);
+  ASSERT_EQUAL(computed, 2);
+  ASSERT_EQUAL(cache.GetStats().hits, 1);
+  ASSERT_EQUAL(cache.GetStats().misses, 2);
+}
+
+void TestDisabledCache() {
+  LruCache<int, int> cache(0);
+  cache.Insert(1, 1);
+  ASSERT(!cache.Find(1).has_value());
+  ASSERT_EQUAL(cache.GetSize(), 0);
+  ASSERT_EQUAL(cache.GetOrCompute(2, [] { return 4; }), 4);
+  ASSERT_EQUAL(cache.GetStats().misses, 2);
+}
+
+void TestConcurrentAccess() {
+  LruCache<int, int> cache(64);
+  vector<thread> threads;
+  vector<int> mismatches(4, 0);
+  for (size_t i = 0; i < mismatches.size(); ++i) {
+    threads.emplace_back([&cache, &mismatches, i] {
+      for (int j = 0; j < 1000; ++j) {
+        const int key = (j * 7 + static_cast<int>(i)) % 100;
+        if (cache.GetOrCompute(key, [key] { return key * 2; }) != key * 2) {
+          ++mismatches[i];
+        }
+      }
+    });
+  }
+  for (auto &t : threads) {
+    t.join();
+  }
+  ASSERT_EQUAL(mismatches, vector<int>(4, 0));
+  ASSERT(cache.GetSize() <= 64);
+  const auto stats = cache.GetStats();
+  ASSERT_EQUAL(stats.hits + stats.misses, 4000);
+}
+
+}
+
+void LruCacheRunTest() {
+  TestFindAndInsert();
+  TestGetOrCompute();
+  TestDisabledCache();
+  TestConcurrentAccess();
+}
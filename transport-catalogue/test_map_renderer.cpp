@@ -65,7 +65,7 @@ void TestRenderMap() {
   JsonReader json_reader(tc);
   FillTransportCatalogue(json_reader);
   auto map_render = MapRenderer(GetSettings());
-  const auto doc = map_render.RenderMap(tc.GetAllBuses(), tc.GetAllStops());
+  const auto doc = map_render.RenderMap(tc.GetAllBuses(), tc.GetStops());
   stringstream ostream;
   doc.Render(ostream);
   ASSERT_EQUAL(ostream.str(), "<?xml version=\"1.0\" encoding=\"UTF-8\" ?>\n"
@@ -84,8 +84,22 @@ void TestRenderMap() {
                               "</svg>");
 }
 
+void TestRenderHighlightedStops() {
+  TransportCatalogue tc;
+  JsonReader json_reader(tc);
+  FillTransportCatalogue(json_reader);
+  auto map_render = MapRenderer(GetSettings());
+  auto expected = map_render.RenderMapToString(tc.GetAllBuses(), tc.GetStops());
+  const string first_circle = "<circle cx=\"30\" cy=\"30\" r=\"5\" fill=\"white\"/>\n"s;
+  expected.insert(expected.find(first_circle), "<circle cx=\"100.817\" cy=\"170\" r=\"10\" fill=\"green\"/>\n"s);
+  const auto map = map_render.RenderMapToString(tc.GetAllBuses(), tc.GetStops(),
+                                                {tc.FindStop("Rasskazovka"s).id});
+  ASSERT_EQUAL(map, expected);
+}
+
 }
 
 void MapRendererRunTest() {
   TestRenderMap();
+  TestRenderHighlightedStops();
 }
@@ -0,0 +1,93 @@
+#include "testing_library.h"
+#include "profiler.h"
+
+#include <sstream>
+#include <thread>
+
+using namespace std;
+
+using namespace profiling;
+
+namespace {
+
+void TestGetBucket() {
+  ASSERT_EQUAL(Profiler::GetBucket(chrono::nanoseconds(500)), 0);
+  ASSERT_EQUAL(Profiler::GetBucket(chrono::microseconds(1)), 1);
+  ASSERT_EQUAL(Profiler::GetBucket(chrono::microseconds(3)), 2);
+  ASSERT_EQUAL(Profiler::GetBucket(chrono::microseconds(4)), 3);
+  ASSERT_EQUAL(Profiler::GetBucket(chrono::hours(1)), Profiler::BUCKET_COUNT - 1);
+}
+
+void TestPhases() {
+  Profiler profiler;
+  profiler.AddPhase("deserialize"s, chrono::milliseconds(5));
+  profiler.AddPhase("process_requests"s, chrono::milliseconds(2));
+  profiler.AddPhase("deserialize"s, chrono::milliseconds(1));
+  {
+    ScopedTimer timer(&profiler, "scoped"s);
+  }
+  {
+    // Без профилировщика таймер ничего не делает
+    ScopedTimer timer(nullptr, "ignored"s);
+  }
+  const auto phases = profiler.GetPhases();
+  ASSERT_EQUAL(phases.size(), 3);
+  ASSERT_EQUAL(phases[0].name, "deserialize"s);
+  ASSERT_EQUAL(phases[0].calls, 2);
+  ASSERT(phases[0].duration == chrono::milliseconds(6));
+  ASSERT_EQUAL(phases[1].name, "process_requests"s);
+  ASSERT_EQUAL(phases[2].name, "scoped"s);
+#ifdef __linux__
+  ASSERT(phases[0].peak_rss_kb > 0);
+#endif
+}
+
+void TestRequests() {
+  Profiler profiler;
+  vector<thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&profiler] {
+      for (int j = 0; j < 100; ++j) {
+        profiler.AddRequest("Bus"s, chrono::microseconds(3));
+      }
+    });
+  }
+  for (auto &t : threads) {
+    t.join();
+  }
+  profiler.AddRequest("Route"s, chrono::microseconds(100));
+  const auto requests = profiler.GetRequests();
+  ASSERT_EQUAL(requests.at("Bus"s).count, 400);
+  ASSERT_EQUAL(requests.at("Bus"s).buckets[2], 400);
+  ASSERT(requests.at("Bus"s).max == chrono::microseconds(3));
+  ASSERT_EQUAL(requests.at("Route"s).count, 1);
+
+  ostringstream out;
+  profiler.Report(out);
+  ASSERT(out.str().find("request Bus: count 400"s) != string::npos);
+  ASSERT(out.str().find("  2-4us: 400\n"s) != string::npos);
+  ASSERT(out.str().find("  64-128us: 1\n"s) != string::npos);
+}
+
+void TestCounters() {
+  Profiler profiler;
+  profiler.SetCounter("route_cache_hits"s, 1);
+  profiler.SetCounter("route_cache_hits"s, 5);
+  profiler.SetCounter("route_cache_misses"s, 2);
+  ASSERT_EQUAL(profiler.GetCounters().at("route_cache_hits"s), 5);
+  ASSERT_EQUAL(profiler.GetCounters().at("route_cache_misses"s), 2);
+
+  ostringstream out;
+  profiler.Report(out);
+  ASSERT(out.str().find("counter route_cache_hits: 5\n"s) != string::npos);
+  ASSERT(out.str().find("counter route_cache_misses: 2\n"s) != string::npos);
+}
+
+}
+
+void ProfilerRunTest() {
+  TestGetBucket();
+  TestPhases();
+  TestRequests();
+  TestCounters();
+}
@@ -2,7 +2,9 @@
 #include "json_reader.h"
 #include "transport_router.h"
 
+#include <fstream>
 #include <sstream>
+#include <thread>
 
 using namespace std;
 
@@ -62,75 +64,8 @@ RenderSettings GetSettings() {
   return request::JsonReader::GetMapSettings(render_settings.AsMap());
 }
 
-void TestGetRouteStat() {
-  TransportCatalogue tc;
-  JsonReader json_reader(tc);
-  FillTransportCatalogue(json_reader);
-  RequestHandler request_handler(tc);
-  const auto bus = request_handler.GetRouteStat("114"s);
-  ASSERT_EQUAL(bus->bus_name, "114"s);
-  ASSERT_EQUAL(bus->stops_count, 3);
-  ASSERT_EQUAL(bus->unique_stops_count, 2);
-  ASSERT_EQUAL(bus->route_distance, 1700);
-  ASSERT(abs(bus->curvature - 1.23199) < 1e-5);
-}
-
-void TestGetBusesThroughStop() {
-  TransportCatalogue tc;
-  JsonReader json_reader(tc);
-  FillTransportCatalogue(json_reader);
-  RequestHandler request_handler(tc);
-  const auto buses = request_handler.GetBusesThroughStop("Rasskazovka"s);
-  set<string_view> rasskazovka_buses{"114"sv};
-  ASSERT_EQUAL(*buses, rasskazovka_buses);
-}
-
-void TestRenderMap() {
-  TransportCatalogue tc;
-  JsonReader json_reader(tc);
-  FillTransportCatalogue(json_reader);
-  RequestHandler request_handler(tc);
-  auto doc = request_handler.RenderMap(GetSettings());
-  stringstream ostream;
-  doc.Render(ostream);
-  ASSERT_EQUAL(ostream.str(), "<?xml version=\"1.0\" encoding=\"UTF-8\" ?>\n"
-                              "<svg xmlns=\"http://www.w3.org/2000/svg\" version=\"1.1\">\n"
-                              "<polyline points=\"100.817,170 30,30 100.817,170\" fill=\"none\" stroke=\"green\" stroke-width=\"14\" stroke-linecap=\"round\" stroke-linejoin=\"round\"/>\n"
-                              "<text x=\"100.817\" y=\"170\" dx=\"7\" dy=\"15\" font-size=\"20\" font-family=\"Verdana\" font-weight=\"bold\" fill=\"rgba(255,255,255,0.85)\" stroke=\"rgba(255,255,255,0.85)\" stroke-width=\"3\" stroke-linecap=\"round\" stroke-linejoin=\"round\">114</text>\n"
-                              "<text x=\"100.817\" y=\"170\" dx=\"7\" dy=\"15\" font-size=\"20\" font-family=\"Verdana\" font-weight=\"bold\" fill=\"green\">114</text>\n"
-                              "<text x=\"30\" y=\"30\" dx=\"7\" dy=\"15\" font-size=\"20\" font-family=\"Verdana\" font-weight=\"bold\" fill=\"rgba(255,255,255,0.85)\" stroke=\"rgba(255,255,255,0.85)\" stroke-width=\"3\" stroke-linecap=\"round\" stroke-linejoin=\"round\">114</text>\n"
-                              "<text x=\"30\" y=\"30\" dx=\"7\" dy=\"15\" font-size=\"20\" font-family=\"Verdana\" font-weight=\"bold\" fill=\"green\">114</text>\n"
-                              "<circle cx=\"30\" cy=\"30\" r=\"5\" fill=\"white\"/>\n"
-                              "<circle cx=\"100.817\" cy=\"170\" r=\"5\" fill=\"white\"/>\n"
-                              "<text x=\"30\" y=\"30\" dx=\"7\" dy=\"-3\" font-size=\"20\" font-family=\"Verdana\" fill=\"rgba(255,255,255,0.85)\" stroke=\"rgba(255,255,255,0.85)\" stroke-width=\"3\" stroke-linecap=\"round\" stroke-linejoin=\"round\">Biryulyovo Zapadnoye</text>\n"
-                              "<text x=\"30\" y=\"30\" dx=\"7\" dy=\"-3\" font-size=\"20\" font-family=\"Verdana\" fill=\"black\">Biryulyovo Zapadnoye</text>\n"
-                              "<text x=\"100.817\" y=\"170\" dx=\"7\" dy=\"-3\" font-size=\"20\" font-family=\"Verdana\" fill=\"rgba(255,255,255,0.85)\" stroke=\"rgba(255,255,255,0.85)\" stroke-width=\"3\" stroke-linecap=\"round\" stroke-linejoin=\"round\">Rasskazovka</text>\n"
-                              "<text x=\"100.817\" y=\"170\" dx=\"7\" dy=\"-3\" font-size=\"20\" font-family=\"Verdana\" fill=\"black\">Rasskazovka</text>\n"
-                              "</svg>");
-}
-
-void TestBuildRoute() {
-  TransportCatalogue tc;
-  JsonReader json_reader(tc);
-  FillTransportCatalogue(json_reader);
-  RequestHandler request_handler(tc);
-  auto route = request_handler.BuildRoute(RoutingSettings{30, 2},
-                                          "Rasskazovka"s,
-                                          "Biryulyovo Zapadnoye"s);
-  ASSERT_EQUAL(route->total_time, 3.7);
-  ASSERT_EQUAL(route->items.size(), 2);
-  ASSERT_EQUAL(get<WaitRouteItem>(route->items[0]).type, "Wait"s);
-  ASSERT_EQUAL(get<WaitRouteItem>(route->items[0]).stop, "Rasskazovka"s);
-  ASSERT_EQUAL(get<WaitRouteItem>(route->items[0]).time, 2);
-  ASSERT_EQUAL(get<BusRouteItem>(route->items[1]).type, "Bus"s);
-  ASSERT_EQUAL(get<BusRouteItem>(route->items[1]).bus, "114"s);
-  ASSERT_EQUAL(get<BusRouteItem>(route->items[1]).time, 1.7);
-  ASSERT_EQUAL(get<BusRouteItem>(route->items[1]).span_count, 1);
-}
-
-void TestProcessJsonRequests() {
-  TransportCatalogue tc;
-  string make_base_request_input = "  {\n"
+string GetMakeBaseRequestInput() {
+  return "  {\n"
                                    "      \"serialization_settings\": {\n"
                                    "          \"file\": \"transport_catalogue.db\"\n"
                                    "      },"
@@ -231,6 +166,131 @@ void TestProcessJsonRequests() {
                                    "          \"bus_wait_time\": 6\n"
                                    "      }\n"
                                    "  }";
+}
+
+void TestGetRouteStat() {
+  TransportCatalogue tc;
+  JsonReader json_reader(tc);
+  FillTransportCatalogue(json_reader);
+  RequestHandler request_handler(tc);
+  const auto bus = request_handler.GetRouteStat("114"s);
+  ASSERT_EQUAL(bus->bus_name, "114"s);
+  ASSERT_EQUAL(bus->stops_count, 3);
+  ASSERT_EQUAL(bus->unique_stops_count, 2);
+  ASSERT_EQUAL(bus->route_distance, 1700);
+  ASSERT(abs(bus->curvature - 1.23199) < 1e-5);
+}
+
+void TestGetBusesThroughStop() {
+  TransportCatalogue tc;
+  JsonReader json_reader(tc);
+  FillTransportCatalogue(json_reader);
+  RequestHandler request_handler(tc);
+  const auto buses = request_handler.GetBusesThroughStop("Rasskazovka"s);
+  set<string_view> rasskazovka_buses{"114"sv};
+  ASSERT_EQUAL(*buses, rasskazovka_buses);
+}
+
+void TestRenderMap() {
+  TransportCatalogue tc;
+  JsonReader json_reader(tc);
+  FillTransportCatalogue(json_reader);
+  RequestHandler request_handler(tc);
+  auto doc = request_handler.RenderMap(GetSettings());
+  stringstream ostream;
+  doc.Render(ostream);
+  ASSERT_EQUAL(ostream.str(), "<?xml version=\"1.0\" encoding=\"UTF-8\" ?>\n"
+                              "<svg xmlns=\"http://www.w3.org/2000/svg\" version=\"1.1\">\n"
+                              "<polyline points=\"100.817,170 30,30 100.817,170\" fill=\"none\" stroke=\"green\" stroke-width=\"14\" stroke-linecap=\"round\" stroke-linejoin=\"round\"/>\n"
+                              "<text x=\"100.817\" y=\"170\" dx=\"7\" dy=\"15\" font-size=\"20\" font-family=\"Verdana\" font-weight=\"bold\" fill=\"rgba(255,255,255,0.85)\" stroke=\"rgba(255,255,255,0.85)\" stroke-width=\"3\" stroke-linecap=\"round\" stroke-linejoin=\"round\">114</text>\n"
+                              "<text x=\"100.817\" y=\"170\" dx=\"7\" dy=\"15\" font-size=\"20\" font-family=\"Verdana\" font-weight=\"bold\" fill=\"green\">114</text>\n"
+                              "<text x=\"30\" y=\"30\" dx=\"7\" dy=\"15\" font-size=\"20\" font-family=\"Verdana\" font-weight=\"bold\" fill=\"rgba(255,255,255,0.85)\" stroke=\"rgba(255,255,255,0.85)\" stroke-width=\"3\" stroke-linecap=\"round\" stroke-linejoin=\"round\">114</text>\n"
+                              "<text x=\"30\" y=\"30\" dx=\"7\" dy=\"15\" font-size=\"20\" font-family=\"Verdana\" font-weight=\"bold\" fill=\"green\">114</text>\n"
+                              "<circle cx=\"30\" cy=\"30\" r=\"5\" fill=\"white\"/>\n"
+                              "<circle cx=\"100.817\" cy=\"170\" r=\"5\" fill=\"white\"/>\n"
+                              "<text x=\"30\" y=\"30\" dx=\"7\" dy=\"-3\" font-size=\"20\" font-family=\"Verdana\" fill=\"rgba(255,255,255,0.85)\" stroke=\"rgba(255,255,255,0.85)\" stroke-width=\"3\" stroke-linecap=\"round\" stroke-linejoin=\"round\">Biryulyovo Zapadnoye</text>\n"
+                              "<text x=\"30\" y=\"30\" dx=\"7\" dy=\"-3\" font-size=\"20\" font-family=\"Verdana\" fill=\"black\">Biryulyovo Zapadnoye</text>\n"
+                              "<text x=\"100.817\" y=\"170\" dx=\"7\" dy=\"-3\" font-size=\"20\" font-family=\"Verdana\" fill=\"rgba(255,255,255,0.85)\" stroke=\"rgba(255,255,255,0.85)\" stroke-width=\"3\" stroke-linecap=\"round\" stroke-linejoin=\"round\">Rasskazovka</text>\n"
+                              "<text x=\"100.817\" y=\"170\" dx=\"7\" dy=\"-3\" font-size=\"20\" font-family=\"Verdana\" fill=\"black\">Rasskazovka</text>\n"
+                              "</svg>");
+}
+
+void TestBuildRoute() {
+  TransportCatalogue tc;
+  JsonReader json_reader(tc);
+  FillTransportCatalogue(json_reader);
+  RequestHandler request_handler(tc);
+  auto route = request_handler.BuildRoute(RoutingSettings{30, 2},
+                                          "Rasskazovka"s,
+                                          "Biryulyovo Zapadnoye"s);
+  ASSERT_EQUAL(route->total_time, 3.7);
+  ASSERT_EQUAL(route->items.size(), 2);
+  ASSERT_EQUAL(get<WaitRouteItem>(route->items[0]).type, "Wait"s);
+  ASSERT_EQUAL(get<WaitRouteItem>(route->items[0]).stop, "Rasskazovka"s);
+  ASSERT_EQUAL(get<WaitRouteItem>(route->items[0]).time, 2);
+  ASSERT_EQUAL(get<BusRouteItem>(route->items[1]).type, "Bus"s);
+  ASSERT_EQUAL(get<BusRouteItem>(route->items[1]).bus, "114"s);
+  ASSERT_EQUAL(get<BusRouteItem>(route->items[1]).time, 1.7);
+  ASSERT_EQUAL(get<BusRouteItem>(route->items[1]).span_count, 1);
+}
+
+void TestQuerySnapshotConcurrentReads() {
+  TransportCatalogue tc;
+  JsonReader json_reader(tc);
+  FillTransportCatalogue(json_reader);
+  const RequestHandler request_handler(tc);
+  const auto snapshot = request_handler.MakeSnapshot(GetSettings(), RoutingSettings{30, 2});
+
+  ostringstream expected_map;
+  snapshot.RenderMap().Render(expected_map);
+  const auto expected_route = snapshot.BuildRoute("Rasskazovka"s, "Biryulyovo Zapadnoye"s);
+  ASSERT(expected_route.has_value());
+  ASSERT_EQUAL(expected_route->total_time, 3.7);
+
+  vector<thread> threads;
+  vector<int> mismatches(4, 0);
+  for (size_t i = 0; i < mismatches.size(); ++i) {
+    threads.emplace_back([&snapshot, &expected_map, &expected_route, &mismatches, i] {
+      for (int j = 0; j < 50; ++j) {
+        ostringstream map;
+        snapshot.RenderMap().Render(map);
+        const auto route = snapshot.BuildRoute("Rasskazovka"s, "Biryulyovo Zapadnoye"s);
+        const auto route_stat = snapshot.GetRouteStat("114"s);
+        const auto buses = snapshot.GetBusesThroughStop("Rasskazovka"s);
+        if (map.str() != expected_map.str() || !route || route->total_time != expected_route->total_time
+            || !route_stat || route_stat->route_distance != 1700 || !buses || buses->count("114"sv) != 1) {
+          ++mismatches[i];
+        }
+      }
+    });
+  }
+  for (auto &t : threads) {
+    t.join();
+  }
+  ASSERT_EQUAL(mismatches, vector<int>(4, 0));
+}
+
+void TestQuerySnapshotRouteCache() {
+  TransportCatalogue tc;
+  JsonReader json_reader(tc);
+  FillTransportCatalogue(json_reader);
+  const RequestHandler request_handler(tc);
+  const auto snapshot = request_handler.MakeSnapshot(GetSettings(), RoutingSettings{30, 2}, 16);
+  for (int i = 0; i < 3; ++i) {
+    const auto route = snapshot.BuildRoute("Rasskazovka"s, "Biryulyovo Zapadnoye"s);
+    ASSERT(route.has_value());
+    ASSERT_EQUAL(route->total_time, 3.7);
+    ASSERT_EQUAL(route->items.size(), 2);
+  }
+  ASSERT_EQUAL(snapshot.GetRouteCacheStats().hits, 2);
+  ASSERT_EQUAL(snapshot.GetRouteCacheStats().misses, 1);
+  // Неизвестные остановки в кэш не попадают
+  ASSERT(!snapshot.BuildRoute("Rasskazovka"s, "Unknown"s).has_value());
+  ASSERT_EQUAL(snapshot.GetRouteCacheStats().misses, 1);
+}
+
+void TestProcessJsonRequests() {
+  TransportCatalogue tc;
   string requests = "  {\n"
                    "      \"serialization_settings\": {\n"
                    "          \"file\": \"transport_catalogue.db\"\n"
@@ -265,7 +325,7 @@ void TestProcessJsonRequests() {
                    "          }\n"
                    "      ]\n"
                    "  }";
-  istringstream make_base_request_istream{make_base_request_input};
+  istringstream make_base_request_istream{GetMakeBaseRequestInput()};
   istringstream requests_istream{requests};
   stringstream ostream;
   RequestHandler request_handler(tc);
@@ -341,6 +401,246 @@ void TestProcessJsonRequests() {
                               "]");
 }
 
+string ProcessStatRequests(const string &execution_settings) {
+  const vector<string> stops{"Biryulyovo Zapadnoye"s, "Universam"s, "Biryulyovo Tovarnaya"s, "Prazhskaya"s};
+  Array stat_requests;
+  int id = 0;
+  for (int i = 0; i < 10; ++i) {
+    stat_requests.emplace_back(Dict{{"id"s, ++id}, {"type"s, "Bus"s}, {"name"s, i % 2 ? "297"s : "635"s}});
+    stat_requests.emplace_back(Dict{{"id"s, ++id}, {"type"s, "Map"s}});
+    for (const auto &from : stops) {
+      stat_requests.emplace_back(Dict{{"id"s, ++id}, {"type"s, "Stop"s}, {"name"s, from}});
+      for (const auto &to : stops) {
+        stat_requests.emplace_back(Dict{{"id"s, ++id}, {"type"s, "Route"s}, {"from"s, from}, {"to"s, to}});
+      }
+    }
+  }
+  ostringstream requests;
+  requests << "{\"serialization_settings\": {\"file\": \"transport_catalogue.db\"},"s
+           << execution_settings << "\"stat_requests\": "s;
+  Print(Document{stat_requests}, requests);
+  requests << "}"s;
+
+  TransportCatalogue tc;
+  RequestHandler request_handler(tc);
+  istringstream make_base_request_istream{GetMakeBaseRequestInput()};
+  request_handler.ProcessMakeBaseRequest(make_base_request_istream);
+  istringstream requests_istream{requests.str()};
+  ostringstream ostream;
+  request_handler.ProcessRequests(requests_istream, ostream);
+  return ostream.str();
+}
+
+void TestProcessRequestsInParallel() {
+  const auto sequential = ProcessStatRequests(""s);
+  ASSERT_EQUAL(ProcessStatRequests("\"execution_settings\": {\"mode\": \"parallel\", \"thread_count\": 4},"s),
+               sequential);
+  ASSERT_EQUAL(ProcessStatRequests("\"execution_settings\": {\"mode\": \"parallel\"},"s), sequential);
+  ASSERT_EQUAL(ProcessStatRequests("\"execution_settings\": {\"mode\": \"sequential\"},"s), sequential);
+}
+
+void TestProcessDuplicateRequests() {
+  for (const auto &mode : {"sequential"s, "parallel"s}) {
+    TransportCatalogue tc;
+    RequestHandler request_handler(tc);
+    istringstream make_base_request_istream{GetMakeBaseRequestInput()};
+    request_handler.ProcessMakeBaseRequest(make_base_request_istream);
+    istringstream requests{
+        "{\"serialization_settings\": {\"file\": \"transport_catalogue.db\"},"
+        "\"execution_settings\": {\"mode\": \""s + mode + "\"},"
+        "\"stat_requests\": ["
+        "{\"id\": 1, \"type\": \"Bus\", \"name\": \"297\"},"
+        "{\"id\": 2, \"type\": \"Route\", \"from\": \"Universam\", \"to\": \"Prazhskaya\"},"
+        "{\"id\": 3, \"type\": \"Bus\", \"name\": \"297\"},"
+        "{\"id\": 4, \"type\": \"Route\", \"from\": \"Prazhskaya\", \"to\": \"Universam\"},"
+        "{\"id\": 5, \"type\": \"Route\", \"from\": \"Universam\", \"to\": \"Prazhskaya\"},"
+        "{\"id\": 6, \"type\": \"Unknown\"},"
+        "{\"id\": 7, \"type\": \"Bus\", \"name\": \"000\"},"
+        "{\"id\": 8, \"type\": \"Bus\", \"name\": \"000\"}]}"s};
+    ostringstream output;
+    request_handler.ProcessRequests(requests, output);
+    istringstream answers_input{output.str()};
+    const auto answers = Load(answers_input).GetRoot().AsArray();
+    ASSERT_EQUAL(answers.size(), 7);
+    const vector<int> expected_ids{1, 2, 3, 4, 5, 7, 8};
+    for (size_t i = 0; i < answers.size(); ++i) {
+      ASSERT_EQUAL(answers[i].AsMap().at("request_id"s).AsInt(), expected_ids[i]);
+    }
+    const auto without_id = [](const Node &answer) {
+      auto dict = answer.AsMap();
+      dict.erase("request_id"s);
+      return dict;
+    };
+    ASSERT(without_id(answers[0]) == without_id(answers[2]));
+    ASSERT(without_id(answers[1]) == without_id(answers[4]));
+    ASSERT(without_id(answers[1]) != without_id(answers[3]));
+    ASSERT_EQUAL(answers[6].AsMap().at("error_message"s).AsString(), "not found"s);
+  }
+}
+
+void TestProcessRouteMatrixRequests() {
+  TransportCatalogue tc;
+  RequestHandler request_handler(tc);
+  istringstream make_base_request_istream{GetMakeBaseRequestInput()};
+  request_handler.ProcessMakeBaseRequest(make_base_request_istream);
+  istringstream requests{
+      "{\"serialization_settings\": {\"file\": \"transport_catalogue.db\"},"
+      "\"stat_requests\": ["
+      "{\"id\": 1, \"type\": \"RouteFromStop\", \"from\": \"Universam\"},"
+      "{\"id\": 2, \"type\": \"RouteMatrix\", \"stops\": [\"Universam\", \"Prazhskaya\", \"Unknown\"],"
+      " \"with_items\": true},"
+      "{\"id\": 3, \"type\": \"RouteMatrix\", \"stops\": [\"Universam\"], \"targets\": [\"Prazhskaya\"]},"
+      "{\"id\": 4, \"type\": \"RouteFromStop\", \"from\": \"Unknown\"},"
+      "{\"id\": 5, \"type\": \"Route\", \"from\": \"Universam\", \"to\": \"Prazhskaya\"},"
+      "{\"id\": 6, \"type\": \"Route\", \"from\": \"Prazhskaya\", \"to\": \"Universam\"}]}"s};
+  ostringstream output;
+  request_handler.ProcessRequests(requests, output);
+  istringstream answers_input{output.str()};
+  const auto answers = Load(answers_input).GetRoot().AsArray();
+  ASSERT_EQUAL(answers.size(), 6);
+  const auto &route_there = answers[4].AsMap();
+  const auto &route_back = answers[5].AsMap();
+
+  const auto &routes = answers[0].AsMap().at("routes"s).AsArray();
+  ASSERT(!routes.empty());
+  bool has_prazhskaya = false;
+  for (size_t i = 0; i < routes.size(); ++i) {
+    const auto &route = routes[i].AsMap();
+    ASSERT(route.find("items"s) == route.end());
+    ASSERT(i == 0 || routes[i - 1].AsMap().at("stop"s).AsString() < route.at("stop"s).AsString());
+    if (route.at("stop"s).AsString() == "Prazhskaya"s) {
+      has_prazhskaya = true;
+      ASSERT(route.at("total_time"s) == route_there.at("total_time"s));
+    }
+  }
+  ASSERT(has_prazhskaya);
+
+  const auto &total_times = answers[1].AsMap().at("total_times"s).AsArray();
+  const auto &items = answers[1].AsMap().at("items"s).AsArray();
+  ASSERT_EQUAL(total_times.size(), 3);
+  ASSERT_EQUAL(total_times[0].AsArray()[0].AsDouble(), 0.);
+  ASSERT(total_times[0].AsArray()[1] == route_there.at("total_time"s));
+  ASSERT(total_times[1].AsArray()[0] == route_back.at("total_time"s));
+  ASSERT(items[0].AsArray()[1] == route_there.at("items"s));
+  ASSERT(items[1].AsArray()[0] == route_back.at("items"s));
+  for (size_t i = 0; i < 3; ++i) {
+    ASSERT(total_times[2].AsArray()[i].IsNull());
+    ASSERT(total_times[i].AsArray()[2].IsNull());
+    ASSERT(items[i].AsArray()[2].IsNull());
+  }
+
+  const auto &one_cell = answers[2].AsMap();
+  ASSERT(one_cell.find("items"s) == one_cell.end());
+  ASSERT(one_cell.at("total_times"s) == Node(Array{Array{route_there.at("total_time"s)}}));
+  ASSERT_EQUAL(answers[3].AsMap().at("error_message"s).AsString(), "not found"s);
+}
+
+void TestProcessIsochroneRequests() {
+  TransportCatalogue tc;
+  RequestHandler request_handler(tc);
+  istringstream make_base_request_istream{GetMakeBaseRequestInput()};
+  request_handler.ProcessMakeBaseRequest(make_base_request_istream);
+  istringstream requests{
+      "{\"serialization_settings\": {\"file\": \"transport_catalogue.db\"},"
+      "\"stat_requests\": ["
+      "{\"id\": 1, \"type\": \"RouteFromStop\", \"from\": \"Universam\"},"
+      "{\"id\": 2, \"type\": \"Isochrone\", \"from\": \"Universam\", \"max_time\": 10},"
+      "{\"id\": 3, \"type\": \"Isochrone\", \"from\": \"Universam\", \"max_time\": 10, \"render_map\": true},"
+      "{\"id\": 4, \"type\": \"Isochrone\", \"from\": \"Unknown\", \"max_time\": 10},"
+      "{\"id\": 5, \"type\": \"Map\"},"
+      "{\"id\": 6, \"type\": \"Isochrone\", \"from\": \"Universam\", \"max_time\": 10.0},"
+      "{\"id\": 7, \"type\": \"Isochrone\", \"from\": \"Universam\", \"max_time\": 0},"
+      "{\"id\": 8, \"type\": \"Isochrone\", \"from\": \"Universam\", \"max_time\": -0.0}]}"s};
+  ostringstream output;
+  request_handler.ProcessRequests(requests, output);
+  istringstream answers_input{output.str()};
+  const auto answers = Load(answers_input).GetRoot().AsArray();
+  ASSERT_EQUAL(answers.size(), 8);
+
+  size_t expected_count = 0;
+  for (const auto &route : answers[0].AsMap().at("routes"s).AsArray()) {
+    expected_count += route.AsMap().at("total_time"s).AsDouble() <= 10. ? 1 : 0;
+  }
+  const auto &stops = answers[1].AsMap().at("stops"s).AsArray();
+  ASSERT_EQUAL(stops.size(), expected_count);
+  ASSERT(stops.size() > 1);
+  ASSERT_EQUAL(stops[0].AsMap().at("stop"s).AsString(), "Universam"s);
+  ASSERT_EQUAL(stops[0].AsMap().at("time"s).AsDouble(), 0.);
+  for (size_t i = 1; i < stops.size(); ++i) {
+    ASSERT(stops[i - 1].AsMap().at("time"s).AsDouble() <= stops[i].AsMap().at("time"s).AsDouble());
+    ASSERT(stops[i].AsMap().at("time"s).AsDouble() <= 10.);
+  }
+  ASSERT(answers[1].AsMap().find("map"s) == answers[1].AsMap().end());
+
+  ASSERT(answers[2].AsMap().at("stops"s) == answers[1].AsMap().at("stops"s));
+  const auto &isochrone_map = answers[2].AsMap().at("map"s).AsString();
+  const auto &map = answers[4].AsMap().at("map"s).AsString();
+  ASSERT(isochrone_map.size() > map.size());
+  ASSERT_EQUAL(answers[3].AsMap().at("error_message"s).AsString(), "not found"s);
+
+  // Целое и дробное время, 0 и -0 - одинаковые запросы
+  ASSERT(answers[5].AsMap().at("stops"s) == answers[1].AsMap().at("stops"s));
+  ASSERT_EQUAL(answers[6].AsMap().at("stops"s).AsArray().size(), 1);
+  ASSERT(answers[7].AsMap().at("stops"s) == answers[6].AsMap().at("stops"s));
+}
+
+void TestProcessRequestsProfile() {
+  const string profile_path = "transport_catalogue_profile.txt"s;
+  for (const auto &mode : {"sequential"s, "parallel"s}) {
+    const auto answers = ProcessStatRequests("\"execution_settings\": {\"mode\": \""s + mode
+                                                 + "\", \"profile_output\": \""s + profile_path + "\"},"s);
+    ASSERT_EQUAL(answers, ProcessStatRequests(""s));
+    ifstream input(profile_path);
+    const string profile{istreambuf_iterator<char>(input), istreambuf_iterator<char>()};
+    for (const auto &expected : {"read_stat_requests"s, "deserialize"s, "process_requests"s, "write_answers"s,
+                                 // Повторяющиеся запросы выполняются один раз
+                                 "request Bus: count 2"s, "request Map: count 1"s,
+                                 "request Route: count 16"s, "request Stop: count 4"s,
+                                 "counter route_cache_hits: "s, "counter route_cache_misses: "s}) {
+      ASSERT_HINT(profile.find(expected) != string::npos, expected);
+    }
+  }
+}
+
+void TestServe() {
+  {
+    TransportCatalogue tc;
+    RequestHandler request_handler(tc);
+    istringstream make_base_request_istream{GetMakeBaseRequestInput()};
+    request_handler.ProcessMakeBaseRequest(make_base_request_istream);
+  }
+  TransportCatalogue tc;
+  RequestHandler request_handler(tc);
+  istringstream input{"\n"
+                      "{\"serialization_settings\": {\"file\": \"transport_catalogue.db\"}}\n"
+                      "{\"id\": 1, \"type\": \"Bus\", \"name\": \"297\"}\n"
+                      "\n"
+                      "{\"id\": 2, \"type\": \"Stop\", \"name\": \"Universam\"}\n"
+                      "{\"id\": 3, \"type\": \"Bus\", \"name\": \"000\"}\n"
+                      "{\"id\": 4, \"type\": \"Route\", \"from\": \"Biryulyovo Zapadnoye\", \"to\": \"Universam\"}\n"
+                      "{\"id\": 5, \"type\": \"Unknown\"}\n"
+                      "{\"id\": 6, \"type\":\n"
+                      "{\"id\": 7, \"type\": \"Bus\", \"name\": \"635\"}"s};
+  ostringstream output;
+  request_handler.Serve(input, output);
+  istringstream answers{output.str()};
+  vector<string> lines;
+  for (string line; getline(answers, line);) {
+    lines.push_back(line);
+  }
+  ASSERT_EQUAL(lines.size(), 7);
+  ASSERT_EQUAL(lines[0],
+               R"({"curvature":1.42963,"request_id":1,"route_length":5990,"stop_count":4,"unique_stop_count":3})"s);
+  ASSERT_EQUAL(lines[1], R"({"buses":["297","635"],"request_id":2})"s);
+  ASSERT_EQUAL(lines[2], R"({"error_message":"not found","request_id":3})"s);
+  ASSERT_EQUAL(lines[3], R"({"items":[{"stop_name":"Biryulyovo Zapadnoye","time":6,"type":"Wait"},)"
+                         R"({"bus":"297","span_count":2,"time":5.235,"type":"Bus"}],"request_id":4,"total_time":11.235})"s);
+  ASSERT_EQUAL(lines[4], R"({"error_message":"unknown request type","request_id":5})"s);
+  ASSERT(lines[5].find("\"error_message\""s) != string::npos);
+  ASSERT_EQUAL(lines[6],
+               R"({"curvature":1.30156,"request_id":7,"route_length":11570,"stop_count":5,"unique_stop_count":3})"s);
+}
+
 }
 
 void RequestHandlerRunTest() {
@@ -348,5 +648,13 @@ void RequestHandlerRunTest() {
   TestGetBusesThroughStop();
   TestRenderMap();
   TestBuildRoute();
+  TestQuerySnapshotConcurrentReads();
+  TestQuerySnapshotRouteCache();
   TestProcessJsonRequests();
+  TestProcessRequestsInParallel();
+  TestProcessDuplicateRequests();
+  TestProcessRouteMatrixRequests();
+  TestProcessIsochroneRequests();
+  TestProcessRequestsProfile();
+  TestServe();
 }
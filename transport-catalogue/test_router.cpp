@@ -46,8 +46,70 @@ void TestBuildRoute() {
   }
 }
 
+void TestRestoreRoutesInternalData() {
+  DirectedWeightedGraph<int> graph(5);
+  graph.AddEdge(Edge<int>{0, 1, 3});
+  graph.AddEdge(Edge<int>{1, 2, 4});
+  graph.AddEdge(Edge<int>{0, 2, 10});
+  graph.AddEdge(Edge<int>{2, 3, 1});
+  Router router(graph);
+  Router<int> restored_router(graph, router.GetRoutesInternalData());
+  for (VertexId from = 0; from < graph.GetVertexCount(); ++from) {
+    for (VertexId to = 0; to < graph.GetVertexCount(); ++to) {
+      const auto route = router.BuildRoute(from, to);
+      const auto restored_route = restored_router.BuildRoute(from, to);
+      ASSERT_EQUAL(restored_route.has_value(), route.has_value());
+      if (route) {
+        ASSERT_EQUAL(restored_route->weight, route->weight);
+        ASSERT_EQUAL(restored_route->edges, route->edges);
+      }
+    }
+  }
+}
+
+void TestRoutesInternalDataMismatch() {
+  DirectedWeightedGraph<int> graph(3);
+  try {
+    Router<int> router(graph, Router<int>::RoutesInternalData(2));
+    ASSERT_HINT(false, "invalid_argument is expected"s);
+  } catch (const invalid_argument &) {
+  }
+}
+
+void TestInvalidRoutesInternalData() {
+  DirectedWeightedGraph<int> graph(3);
+  graph.AddEdge(Edge<int>{0, 1, 1});
+  graph.AddEdge(Edge<int>{1, 2, 1});
+  graph.AddEdge(Edge<int>{2, 1, 1});
+  const auto valid = Router(graph).GetRoutesInternalData();
+  ASSERT(IsValidAllPairsRoutes(valid, graph));
+
+  vector<Router<int>::RoutesInternalData> invalid_routes(5, valid);
+  // Несуществующее ребро
+  invalid_routes[0][0][2]->prev_edge = 7;
+  // Ребро ведёт не в ту вершину
+  invalid_routes[1][0][2]->prev_edge = 0;
+  // Нет пути до начала ребра
+  invalid_routes[2][0][1].reset();
+  // Путь без рёбер в другую вершину
+  invalid_routes[3][0][2]->prev_edge.reset();
+  // Последние рёбра путей образуют цикл 1 -> 2 -> 1
+  invalid_routes[4][0][1]->prev_edge = 2;
+  for (auto &routes_internal_data : invalid_routes) {
+    ASSERT(!IsValidAllPairsRoutes(routes_internal_data, graph));
+    try {
+      Router<int> router(graph, std::move(routes_internal_data));
+      ASSERT_HINT(false, "invalid_argument is expected"s);
+    } catch (const invalid_argument &) {
+    }
+  }
+}
+
 }
 
 void RouterRunTest() {
   TestBuildRoute();
+  TestRestoreRoutesInternalData();
+  TestRoutesInternalDataMismatch();
+  TestInvalidRoutesInternalData();
 }
@@ -6,6 +6,10 @@
 #include "map_renderer.h"
 #include "serialization.h"
 
+#include <transport_catalogue.pb.h>
+
+#include <fstream>
+
 using namespace std;
 
 using namespace transport_catalogue;
@@ -52,13 +56,14 @@ void TestSerializationDeserializationProcess() {
   Serialize(serialization_settings, tc, render_settings, tr);
 
   TransportCatalogue deserialized_tc;
-  const auto [deserialized_render_settings, deserialized_tr] =
+  const auto [deserialized_render_settings, deserialized_tr, rendered_map] =
       Deserialize(serialization_settings, deserialized_tc);
   ASSERT_EQUAL(deserialized_tc.GetAllDistances().size(), tc.GetAllDistances().size());
   ASSERT_EQUAL(deserialized_tc.GetAllStops().size(), tc.GetAllStops().size());
   ASSERT_EQUAL(deserialized_tc.GetAllBuses().size(), tc.GetAllBuses().size());
   ASSERT_EQUAL(deserialized_tc.GetAllBuses().size(), tc.GetAllBuses().size());
   ASSERT_EQUAL(render_settings.width, deserialized_render_settings.width);
+  ASSERT(!rendered_map.has_value());
   ASSERT_EQUAL(render_settings.height, deserialized_render_settings.height);
   ASSERT_EQUAL(render_settings.padding, deserialized_render_settings.padding);
   ASSERT_EQUAL(render_settings.stop_radius, deserialized_render_settings.stop_radius);
@@ -100,8 +105,246 @@ void TestSerializationDeserializationProcess() {
                tr.GetRoutingSettings().bus_wait_time);
 }
 
+void TestContractionHierarchySerialization() {
+  TransportCatalogue tc;
+  AddCircularAndLinearBuses(tc);
+  TransportRouter tr(tc, RoutingSettings{30, 2, RouterType::CONTRACTION_HIERARCHY});
+  SerializationSettings serialization_settings{"transport_catalogue.db"s};
+  Serialize(serialization_settings, tc, RenderSettings{}, tr);
+
+  TransportCatalogue deserialized_tc;
+  const auto [_, deserialized_tr, rendered_map] = Deserialize(serialization_settings, deserialized_tc);
+  ASSERT(deserialized_tr.GetRoutingSettings().router_type == RouterType::CONTRACTION_HIERARCHY);
+  const auto &hierarchy =
+      get<TransportRouter::ContractionHierarchyRouter>(tr.GetRouter()).GetContractionHierarchy();
+  const auto &deserialized_hierarchy =
+      get<TransportRouter::ContractionHierarchyRouter>(deserialized_tr.GetRouter()).GetContractionHierarchy();
+  ASSERT_EQUAL(deserialized_hierarchy.ranks, hierarchy.ranks);
+  ASSERT_EQUAL(deserialized_hierarchy.shortcuts.size(), hierarchy.shortcuts.size());
+  for (const auto &[from, _] : tc.GetAllStops()) {
+    for (const auto &[to, _] : tc.GetAllStops()) {
+      const auto route = tr.BuildRoute(from, to);
+      const auto deserialized_route = deserialized_tr.BuildRoute(from, to);
+      ASSERT_EQUAL(deserialized_route.has_value(), route.has_value());
+      if (route) {
+        ASSERT_EQUAL(deserialized_route->total_time, route->total_time);
+      }
+    }
+  }
+}
+
+void TestRideVerticesSerialization() {
+  TransportCatalogue tc;
+  AddCircularAndLinearBuses(tc);
+  TransportRouter tr(tc, RoutingSettings{30, 2, RouterType::DIJKSTRA, GraphModel::RIDE_VERTICES});
+  SerializationSettings serialization_settings{"transport_catalogue.db"s};
+  Serialize(serialization_settings, tc, RenderSettings{}, tr);
+
+  TransportCatalogue deserialized_tc;
+  const auto [_, deserialized_tr, rendered_map] = Deserialize(serialization_settings, deserialized_tc);
+  ASSERT(deserialized_tr.GetRoutingSettings().graph_model == GraphModel::RIDE_VERTICES);
+  ASSERT_EQUAL(deserialized_tr.GetGraph().GetEdgeCount(), tr.GetGraph().GetEdgeCount());
+  for (const auto &[from, _] : tc.GetAllStops()) {
+    for (const auto &[to, _] : tc.GetAllStops()) {
+      const auto route = tr.BuildRoute(from, to);
+      const auto deserialized_route = deserialized_tr.BuildRoute(from, to);
+      ASSERT_EQUAL(deserialized_route.has_value(), route.has_value());
+      if (route) {
+        ASSERT_EQUAL(deserialized_route->total_time, route->total_time);
+        ASSERT_EQUAL(deserialized_route->items.size(), route->items.size());
+      }
+    }
+  }
+}
+
+void TestRouteStatSerialization() {
+  TransportCatalogue tc;
+  AddCircularAndLinearBuses(tc);
+  TransportRouter tr(tc, RoutingSettings{30, 2});
+  SerializationSettings serialization_settings{"transport_catalogue.db"s};
+  Serialize(serialization_settings, tc, RenderSettings{}, tr);
+
+  TransportCatalogue deserialized_tc;
+  const auto [_, deserialized_tr, rendered_map] = Deserialize(serialization_settings, deserialized_tc);
+  for (const auto bus : tc.GetAllBuses()) {
+    const auto &deserialized_bus = deserialized_tc.FindBus(bus->name);
+    ASSERT_EQUAL(deserialized_bus.unique_stops_count, bus->unique_stops_count);
+    ASSERT_EQUAL(deserialized_bus.geo_route_distance, bus->geo_route_distance);
+    ASSERT_EQUAL(deserialized_bus.route_distance, bus->route_distance);
+    ASSERT_EQUAL(deserialized_bus.curvature, bus->curvature);
+    ASSERT_EQUAL(deserialized_bus.stops_on_route, bus->stops_on_route);
+  }
+  const auto buses_through_stop = deserialized_tc.GetBusesThroughStop("Rasskazovka"sv);
+  ASSERT_EQUAL(buses_through_stop->size(), 2u);
+}
+
+void TestAllPairsIndexSerialization() {
+  TransportCatalogue tc;
+  AddCircularAndLinearBuses(tc);
+  TransportRouter tr(tc, RoutingSettings{30, 2, RouterType::ALL_PAIRS});
+  SerializationSettings serialization_settings{"transport_catalogue.db"s};
+  Serialize(serialization_settings, tc, RenderSettings{}, tr);
+
+  TransportCatalogue deserialized_tc;
+  const auto [_, deserialized_tr, rendered_map] = Deserialize(serialization_settings, deserialized_tc);
+  const auto &routes = get<TransportRouter::AllPairsRouter>(tr.GetRouter()).GetRoutesInternalData();
+  const auto &deserialized_routes =
+      get<TransportRouter::AllPairsRouter>(deserialized_tr.GetRouter()).GetRoutesInternalData();
+  ASSERT_EQUAL(deserialized_routes.size(), routes.size());
+  for (size_t from = 0; from < routes.size(); ++from) {
+    for (size_t to = 0; to < routes.size(); ++to) {
+      ASSERT_EQUAL(deserialized_routes[from][to].has_value(), routes[from][to].has_value());
+      if (routes[from][to]) {
+        ASSERT_EQUAL(deserialized_routes[from][to]->weight, routes[from][to]->weight);
+        ASSERT(deserialized_routes[from][to]->prev_edge == routes[from][to]->prev_edge);
+      }
+    }
+  }
+}
+
+void TestStaleRouterIndexIsRejected() {
+  TransportCatalogue tc;
+  AddCircularAndLinearBuses(tc);
+  TransportRouter tr(tc, RoutingSettings{30, 2, RouterType::ALL_PAIRS});
+  SerializationSettings serialization_settings{"transport_catalogue.db"s};
+  Serialize(serialization_settings, tc, RenderSettings{}, tr);
+
+  // Индекс старой версии с испорченными путями должен быть построен заново
+  proto_tc::TransportCatalogue proto_catalogue;
+  {
+    ifstream input(serialization_settings.db_path, ios::binary);
+    proto_catalogue.ParseFromIstream(&input);
+  }
+  auto &proto_router = *proto_catalogue.mutable_router();
+  proto_router.set_index_version(0);
+  for (auto &weight : *proto_router.mutable_all_pairs_routes()->mutable_weights()) {
+    weight = -1.;
+  }
+  {
+    ofstream output(serialization_settings.db_path, ios::binary);
+    proto_catalogue.SerializeToOstream(&output);
+  }
+
+  TransportCatalogue deserialized_tc;
+  const auto [_, deserialized_tr, rendered_map] = Deserialize(serialization_settings, deserialized_tc);
+  for (const auto &[from, _] : tc.GetAllStops()) {
+    for (const auto &[to, _] : tc.GetAllStops()) {
+      const auto route = tr.BuildRoute(from, to);
+      const auto deserialized_route = deserialized_tr.BuildRoute(from, to);
+      ASSERT_EQUAL(deserialized_route.has_value(), route.has_value());
+      if (route) {
+        ASSERT_EQUAL(deserialized_route->total_time, route->total_time);
+      }
+    }
+  }
+}
+
+void TestInvalidContractionHierarchyIsRebuilt() {
+  TransportCatalogue tc;
+  AddCircularAndLinearBuses(tc);
+  TransportRouter tr(tc, RoutingSettings{30, 2, RouterType::CONTRACTION_HIERARCHY});
+  SerializationSettings serialization_settings{"transport_catalogue.db"s};
+  Serialize(serialization_settings, tc, RenderSettings{}, tr);
+
+  // Сокращения с несуществующими вершинами и рёбрами отбрасываются вместе со всей иерархией
+  proto_tc::TransportCatalogue proto_catalogue;
+  {
+    ifstream input(serialization_settings.db_path, ios::binary);
+    proto_catalogue.ParseFromIstream(&input);
+  }
+  auto &proto_hierarchy = *proto_catalogue.mutable_router()->mutable_contraction_hierarchy();
+  auto &proto_shortcut = *proto_hierarchy.add_shortcuts();
+  proto_shortcut.set_from(1000);
+  proto_shortcut.set_to(0);
+  proto_shortcut.set_first(1000000);
+  proto_shortcut.set_second(0);
+  {
+    ofstream output(serialization_settings.db_path, ios::binary);
+    proto_catalogue.SerializeToOstream(&output);
+  }
+
+  TransportCatalogue deserialized_tc;
+  const auto [_, deserialized_tr, rendered_map] = Deserialize(serialization_settings, deserialized_tc);
+  for (const auto &[from, _] : tc.GetAllStops()) {
+    for (const auto &[to, _] : tc.GetAllStops()) {
+      const auto route = tr.BuildRoute(from, to);
+      const auto deserialized_route = deserialized_tr.BuildRoute(from, to);
+      ASSERT_EQUAL(deserialized_route.has_value(), route.has_value());
+      if (route) {
+        ASSERT(abs(deserialized_route->total_time - route->total_time) < 1e-9);
+      }
+    }
+  }
+}
+
+void TestInvalidAllPairsRoutesAreRebuilt() {
+  TransportCatalogue tc;
+  AddCircularAndLinearBuses(tc);
+  TransportRouter tr(tc, RoutingSettings{30, 2, RouterType::ALL_PAIRS});
+  SerializationSettings serialization_settings{"transport_catalogue.db"s};
+  Serialize(serialization_settings, tc, RenderSettings{}, tr);
+
+  // Пути с несуществующими рёбрами отбрасываются вместе со всей таблицей
+  proto_tc::TransportCatalogue proto_catalogue;
+  {
+    ifstream input(serialization_settings.db_path, ios::binary);
+    proto_catalogue.ParseFromIstream(&input);
+  }
+  auto &proto_all_pairs_routes = *proto_catalogue.mutable_router()->mutable_all_pairs_routes();
+  ASSERT(proto_all_pairs_routes.prev_edges_size() > 0);
+  for (int i = 0; i < proto_all_pairs_routes.prev_edges_size(); ++i) {
+    if (proto_all_pairs_routes.prev_edges(i) > 0) {
+      proto_all_pairs_routes.set_prev_edges(i, 1000000);
+    }
+  }
+  {
+    ofstream output(serialization_settings.db_path, ios::binary);
+    proto_catalogue.SerializeToOstream(&output);
+  }
+
+  TransportCatalogue deserialized_tc;
+  const auto [_, deserialized_tr, rendered_map] = Deserialize(serialization_settings, deserialized_tc);
+  for (const auto &[from, _] : tc.GetAllStops()) {
+    for (const auto &[to, _] : tc.GetAllStops()) {
+      const auto route = tr.BuildRoute(from, to);
+      const auto deserialized_route = deserialized_tr.BuildRoute(from, to);
+      ASSERT_EQUAL(deserialized_route.has_value(), route.has_value());
+      if (route) {
+        ASSERT(abs(deserialized_route->total_time - route->total_time) < 1e-9);
+      }
+    }
+  }
+}
+
+void TestPrerenderedMapSerialization() {
+  TransportCatalogue tc;
+  AddCircularAndLinearBuses(tc);
+  TransportRouter tr(tc, RoutingSettings{30, 2});
+  RenderSettings render_settings{200, 200, 30, 5, 14, 20, {7, 15}, 20, {7, -3},
+                                 svg::Rgba{255, 254, 253, 0.85}, 3,
+                                 {"green"s, svg::Rgb{255, 160, 0}, "red"s}};
+  const auto expected_map = MapRenderer(render_settings).RenderMapToString(tc.GetAllBuses(), tc.GetStops());
+  for (const auto format : {DatabaseFormat::PROTOBUF, DatabaseFormat::FLAT}) {
+    SerializationSettings serialization_settings{"transport_catalogue.db"s, format, true};
+    Serialize(serialization_settings, tc, render_settings, tr);
+
+    TransportCatalogue deserialized_tc;
+    const auto [_, deserialized_tr, rendered_map] = Deserialize(serialization_settings, deserialized_tc);
+    ASSERT(rendered_map.has_value());
+    ASSERT_EQUAL(*rendered_map, expected_map);
+  }
+}
+
 }
 
 void SerializationRunTest() {
   TestSerializationDeserializationProcess();
+  TestContractionHierarchySerialization();
+  TestRideVerticesSerialization();
+  TestRouteStatSerialization();
+  TestAllPairsIndexSerialization();
+  TestStaleRouterIndexIsRejected();
+  TestInvalidContractionHierarchyIsRebuilt();
+  TestInvalidAllPairsRoutesAreRebuilt();
+  TestPrerenderedMapSerialization();
 }
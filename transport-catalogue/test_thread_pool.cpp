@@ -0,0 +1,52 @@
+#include "testing_library.h"
+#include "thread_pool.h"
+
+#include <atomic>
+#include <stdexcept>
+
+using namespace std;
+
+using namespace concurrency;
+
+namespace {
+
+void TestSubmit() {
+  ThreadPool pool(4);
+  ASSERT_EQUAL(pool.GetThreadCount(), 4);
+  vector<future<int>> results;
+  for (int i = 0; i < 100; ++i) {
+    results.push_back(pool.Submit([i] { return i * i; }));
+  }
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_EQUAL(results[i].get(), i * i);
+  }
+}
+
+void TestException() {
+  ThreadPool pool(2);
+  auto result = pool.Submit([]() -> int { throw invalid_argument("Task failed"s); });
+  try {
+    result.get();
+    ASSERT_HINT(false, "Exception should be passed through the future"s);
+  } catch (const invalid_argument &) {
+  }
+}
+
+void TestDestructorRunsQueuedTasks() {
+  atomic<int> counter = 0;
+  {
+    ThreadPool pool(1);
+    for (int i = 0; i < 50; ++i) {
+      pool.Submit([&counter] { ++counter; });
+    }
+  }
+  ASSERT_EQUAL(counter.load(), 50);
+}
+
+}
+
+void ThreadPoolRunTest() {
+  TestSubmit();
+  TestException();
+  TestDestructorRunsQueuedTasks();
+}
@@ -260,6 +260,70 @@ void TestGetDistanceBetweenStops() {
   ASSERT(!tc.GetDistanceBetweenStops("Tolstopaltsevo"sv, "Tolstopaltsevo"sv).has_value());
 }
 
+
+void TestStopAndBusIds() {
+  TransportCatalogue tc;
+  AddLinearBus(tc);
+  ASSERT_EQUAL(tc.GetStopCount(), 3);
+  ASSERT_EQUAL(tc.GetBusCount(), 1);
+  const auto tolstopaltsevo = tc.GetStopId("Tolstopaltsevo"sv);
+  const auto marushkino = tc.GetStopId("Marushkino"sv);
+  const auto rasskazovka = tc.GetStopId("Rasskazovka"sv);
+  ASSERT_EQUAL(tolstopaltsevo, 0);
+  ASSERT_EQUAL(marushkino, 1);
+  ASSERT_EQUAL(rasskazovka, 2);
+  ASSERT_EQUAL(tc.GetStop(marushkino).name, "Marushkino"s);
+  ASSERT_EQUAL(tc.GetStops()[rasskazovka]->name, "Rasskazovka"s);
+
+  const auto &bus = tc.GetBus(tc.GetBusId("750"sv));
+  ASSERT_EQUAL(bus.name, "750"s);
+  ASSERT_EQUAL(bus.stop_ids_on_route,
+               (vector<StopId>{tolstopaltsevo, marushkino, marushkino, rasskazovka}));
+
+  ASSERT_EQUAL(tc.GetDistance(tolstopaltsevo, marushkino).value(), 3900);
+  ASSERT_EQUAL(tc.GetDistance(marushkino, tolstopaltsevo).value(), 3700);
+  ASSERT_EQUAL(tc.GetDistance(rasskazovka, marushkino).value(), 9900);
+  ASSERT(!tc.GetDistance(tolstopaltsevo, rasskazovka).has_value());
+  try {
+    (void) tc.GetStopId("Universam"sv);
+    ASSERT_HINT(false, "Unknown stop should throw"s);
+  } catch (const out_of_range &) {
+  }
+}
+
+
+void TestSingleInstance() {
+  TransportCatalogue tc;
+  AddCircularAndLinearBuses(tc);
+  const auto marushkino = tc.GetStopId("Marushkino"sv);
+  const auto &stop = tc.FindStop("Marushkino"sv);
+  ASSERT_EQUAL(&stop, tc.GetStops()[marushkino]);
+  ASSERT_EQUAL(&stop, &tc.GetStop(marushkino));
+  ASSERT_EQUAL(&stop, tc.GetAllStops().at("Marushkino"sv));
+  ASSERT_EQUAL(stop.buses_through_stop, (set<string_view>{"750"sv}));
+
+  const auto &bus = tc.FindBus("750"sv);
+  ASSERT_EQUAL(&bus, &tc.GetBus(tc.GetBusId("750"sv)));
+  ASSERT_EQUAL(&bus, tc.GetAllBuses()[0]);
+  // Имена остановок маршрута ссылаются на строки единственных экземпляров остановок
+  ASSERT(bus.stops_on_route[1].data() == stop.name.data());
+  ASSERT(stop.buses_through_stop.begin()->data() == bus.name.data());
+}
+
+
+void TestDistanceAddedAfterBuses() {
+  TransportCatalogue tc;
+  AddLinearBus(tc);
+  const auto tolstopaltsevo = tc.GetStopId("Tolstopaltsevo"sv);
+  const auto rasskazovka = tc.GetStopId("Rasskazovka"sv);
+  ASSERT(!tc.GetDistance(tolstopaltsevo, rasskazovka).has_value());
+  tc.AddDistance(rasskazovka, tolstopaltsevo, 12000);
+  ASSERT_EQUAL(tc.GetDistance(tolstopaltsevo, rasskazovka).value(), 12000);
+  tc.BuildDistanceMatrix();
+  ASSERT_EQUAL(tc.GetDistance(tolstopaltsevo, rasskazovka).value(), 12000);
+  ASSERT_EQUAL(tc.GetDistanceBetweenStops("Marushkino"sv, "Tolstopaltsevo"sv).value(), 3700);
+}
+
 }
 
 void TransportCatalogueRunTest() {
@@ -273,4 +337,7 @@ void TransportCatalogueRunTest() {
   TestGetRouteStatForCircularBus();
   TestGetRouteStatForLinearBus();
   TestGetDistanceBetweenStops();
+  TestStopAndBusIds();
+  TestSingleInstance();
+  TestDistanceAddedAfterBuses();
 }
@@ -4,6 +4,8 @@
 #include "geo.h"
 #include "transport_router.h"
 
+#include <algorithm>
+
 using namespace std;
 
 using namespace transport_catalogue;
@@ -86,6 +88,200 @@ void TestBuildRoute() {
   }
 }
 
+void TestRouterTypesGiveSameTime() {
+  TransportCatalogue tc;
+  AddCircularAndLinearBuses(tc);
+  TransportRouter all_pairs_tr(tc, RoutingSettings{30, 2, RouterType::ALL_PAIRS});
+  for (const auto router_type : {RouterType::DIJKSTRA, RouterType::CONTRACTION_HIERARCHY}) {
+    TransportRouter tr(tc, RoutingSettings{30, 2, router_type});
+    for (const auto &[from, _] : tc.GetAllStops()) {
+      for (const auto &[to, _] : tc.GetAllStops()) {
+        const auto expected = all_pairs_tr.BuildRoute(from, to);
+        const auto route = tr.BuildRoute(from, to);
+        ASSERT_EQUAL(route.has_value(), expected.has_value());
+        if (route) {
+          ASSERT(abs(route->total_time - expected->total_time) < 1e-9);
+          ASSERT_EQUAL(route->items.size(), expected->items.size());
+        }
+      }
+    }
+  }
+}
+
+void TestBuildRoutes() {
+  TransportCatalogue tc;
+  AddCircularAndLinearBuses(tc);
+  tc.AddStop({"Lonely"s, {55.6, 37.6}});
+  vector<string_view> stops;
+  for (const auto &[stop, _] : tc.GetAllStops()) {
+    stops.push_back(stop);
+  }
+  stops.push_back("Unknown"sv);
+  for (const auto graph_model : {GraphModel::STOP_PAIRS, GraphModel::RIDE_VERTICES}) {
+    TransportRouter tr(tc, RoutingSettings{30, 2, RouterType::CONTRACTION_HIERARCHY, graph_model});
+    for (const auto from : stops) {
+      const auto times = tr.BuildRoutes(from, stops, false);
+      const auto routes = tr.BuildRoutes(from, stops, true);
+      ASSERT_EQUAL(times.size(), stops.size());
+      for (size_t i = 0; i < stops.size(); ++i) {
+        const auto expected = tr.BuildRoute(from, stops[i]);
+        ASSERT_EQUAL(times[i].has_value(), expected.has_value());
+        ASSERT_EQUAL(routes[i].has_value(), expected.has_value());
+        if (expected) {
+          ASSERT(abs(times[i]->total_time - expected->total_time) < 1e-9);
+          ASSERT(times[i]->items.empty());
+          ASSERT(abs(routes[i]->total_time - expected->total_time) < 1e-9);
+          ASSERT_EQUAL(routes[i]->items.size(), expected->items.size());
+        }
+      }
+    }
+  }
+}
+
+void TestBuildReachableStops() {
+  TransportCatalogue tc;
+  AddCircularAndLinearBuses(tc);
+  for (const auto graph_model : {GraphModel::STOP_PAIRS, GraphModel::RIDE_VERTICES}) {
+    TransportRouter tr(tc, RoutingSettings{30, 2, RouterType::DIJKSTRA, graph_model});
+    for (const double max_time : {-1., 0., 9.8, 20., 41.2, 100.}) {
+      for (const auto &[from, _] : tc.GetAllStops()) {
+        const auto reachable = tr.BuildReachableStops(from, max_time);
+        for (size_t i = 1; i < reachable.size(); ++i) {
+          ASSERT(reachable[i - 1].second <= reachable[i].second);
+        }
+        for (const auto &[to, _] : tc.GetAllStops()) {
+          const auto route = tr.BuildRoute(from, to);
+          const auto it = find_if(reachable.begin(), reachable.end(), [to = to](const auto &stop) {
+            return stop.first == to;
+          });
+          // Сравнение с допуском на порядок сложения времени перегонов
+          if (route && route->total_time < max_time - 1e-9) {
+            ASSERT(it != reachable.end());
+            ASSERT(abs(it->second - route->total_time) < 1e-9);
+          } else if (!route || route->total_time > max_time + 1e-9) {
+            ASSERT(it == reachable.end());
+          }
+        }
+      }
+    }
+  }
+  TransportRouter tr(tc, RoutingSettings{30, 2});
+  const auto reachable = tr.BuildReachableStops("Tolstopaltsevo"sv, 10.);
+  ASSERT_EQUAL(reachable.size(), 2);
+  ASSERT_EQUAL(reachable[0].first, "Tolstopaltsevo"sv);
+  ASSERT_EQUAL(reachable[0].second, 0.);
+  ASSERT_EQUAL(reachable[1].first, "Marushkino"sv);
+  ASSERT_EQUAL(reachable[1].second, 9.8);
+  ASSERT(tr.BuildReachableStops("Unknown"sv, 10.).empty());
+}
+
+void TestRideVerticesGraphModel() {
+  TransportCatalogue tc;
+  AddCircularAndLinearBuses(tc);
+  TransportRouter stop_pairs_tr(tc, RoutingSettings{30, 2});
+  for (const auto router_type : {RouterType::DIJKSTRA, RouterType::CONTRACTION_HIERARCHY}) {
+    TransportRouter tr(tc, RoutingSettings{30, 2, router_type, GraphModel::RIDE_VERTICES});
+    for (const auto &[from, _] : tc.GetAllStops()) {
+      for (const auto &[to, _] : tc.GetAllStops()) {
+        const auto expected = stop_pairs_tr.BuildRoute(from, to);
+        const auto route = tr.BuildRoute(from, to);
+        ASSERT_EQUAL(route.has_value(), expected.has_value());
+        if (!route) {
+          continue;
+        }
+        ASSERT(abs(route->total_time - expected->total_time) < 1e-9);
+        ASSERT_EQUAL(route->items.size(), expected->items.size());
+        double items_time = 0.;
+        int span_count = 0;
+        for (const auto &item : route->items) {
+          if (const auto *bus_item = get_if<BusRouteItem>(&item)) {
+            items_time += bus_item->time;
+            span_count += bus_item->span_count;
+            ASSERT(bus_item->span_count > 0);
+          } else {
+            items_time += get<WaitRouteItem>(item).time;
+          }
+        }
+        ASSERT(abs(items_time - route->total_time) < 1e-9);
+        ASSERT(span_count > 0 || route->items.empty());
+      }
+    }
+  }
+
+  const auto route = TransportRouter(tc, RoutingSettings{30, 2, RouterType::DIJKSTRA, GraphModel::RIDE_VERTICES})
+      .BuildRoute("Universam"sv, "Tolstopaltsevo"sv);
+  ASSERT_EQUAL(route->items.size(), 4);
+  ASSERT_EQUAL(get<WaitRouteItem>(route->items[2]).stop, "Rasskazovka"s);
+  ASSERT_EQUAL(get<BusRouteItem>(route->items[3]).bus, "750"s);
+  ASSERT_EQUAL(get<BusRouteItem>(route->items[3]).time, 26);
+  ASSERT_EQUAL(get<BusRouteItem>(route->items[3]).span_count, 3);
+}
+
+void TestRideVerticesEdgeCount() {
+  TransportCatalogue tc;
+  vector<string> names;
+  for (int i = 0; i < 60; ++i) {
+    names.push_back("Stop "s + to_string(i));
+    tc.AddStop({names.back(), {55.6 + i * 0.001, 37.6}});
+  }
+  vector<string_view> stops(names.begin(), names.end());
+  for (size_t i = 1; i < stops.size(); ++i) {
+    tc.AddDistance({names[i - 1], names[i], 500});
+  }
+  tc.AddBus({"1"s, stops, RouteType::LINEAR});
+
+  TransportRouter stop_pairs_tr(tc, RoutingSettings{30, 2});
+  TransportRouter ride_vertices_tr(tc, RoutingSettings{30, 2, RouterType::DIJKSTRA, GraphModel::RIDE_VERTICES});
+  ASSERT_EQUAL(stop_pairs_tr.GetGraph().GetEdgeCount(), 60 * 59);
+  // Посадка и высадка на каждой остановке, кроме конечных, плюс перегоны, в обе стороны
+  ASSERT_EQUAL(ride_vertices_tr.GetGraph().GetEdgeCount(), 2 * (59 + 59 + 59));
+  const auto expected = stop_pairs_tr.BuildRoute("Stop 3"sv, "Stop 57"sv);
+  const auto route = ride_vertices_tr.BuildRoute("Stop 3"sv, "Stop 57"sv);
+  ASSERT(abs(route->total_time - expected->total_time) < 1e-9);
+  ASSERT_EQUAL(get<BusRouteItem>(route->items[1]).span_count, 54);
+}
+
+void TestParallelBuildKeepsBusOrder() {
+  TransportCatalogue tc;
+  vector<string> names;
+  for (int i = 0; i < 30; ++i) {
+    names.push_back("Stop "s + to_string(i));
+    tc.AddStop({names.back(), {55.6 + i * 0.001, 37.6}});
+  }
+  for (size_t i = 0; i < names.size(); ++i) {
+    for (size_t j = i + 1; j < names.size(); ++j) {
+      tc.AddDistance({names[i], names[j], static_cast<int>(100 * (j - i) + i)});
+    }
+  }
+  for (int bus = 0; bus < 20; ++bus) {
+    vector<string_view> stops;
+    for (int i = bus % 5; i < 30; i += 1 + bus % 3) {
+      stops.emplace_back(names[i]);
+    }
+    tc.AddBus({"Bus "s + to_string(100 + bus), stops,
+               bus % 2 == 0 ? RouteType::LINEAR : RouteType::CIRCULAR});
+  }
+
+  for (const auto graph_model : {GraphModel::STOP_PAIRS, GraphModel::RIDE_VERTICES}) {
+    TransportRouter tr(tc, RoutingSettings{30, 2, RouterType::DIJKSTRA, graph_model});
+    TransportRouter other_tr(tc, RoutingSettings{30, 2, RouterType::DIJKSTRA, graph_model});
+    const auto &graph = tr.GetGraph();
+    ASSERT_EQUAL(graph.GetEdgeCount(), other_tr.GetGraph().GetEdgeCount());
+    // Рёбра автобусов идут подряд в порядке имён автобусов
+    for (graph::EdgeId id = 0; id < graph.GetEdgeCount(); ++id) {
+      ASSERT_EQUAL(graph.GetEdge(id).from, other_tr.GetGraph().GetEdge(id).from);
+      ASSERT_EQUAL(graph.GetEdge(id).to, other_tr.GetGraph().GetEdge(id).to);
+      ASSERT_EQUAL(graph.GetEdge(id).weight, other_tr.GetGraph().GetEdge(id).weight);
+      if (id > 0) {
+        ASSERT(tr.GetEdge(id - 1).first.bus <= tr.GetEdge(id).first.bus);
+      }
+    }
+    for (const auto &name : names) {
+      ASSERT(tr.GetVertexIdByStopName(name) == other_tr.GetVertexIdByStopName(name));
+    }
+  }
+}
+
 void TestGetRoutingSettings() {
   TransportCatalogue tc;
   AddCircularAndLinearBuses(tc);
@@ -93,6 +289,7 @@ void TestGetRoutingSettings() {
   const auto settings = tr.GetRoutingSettings();
   ASSERT_EQUAL(settings.bus_velocity, 500);
   ASSERT_EQUAL(settings.bus_wait_time, 2);
+  ASSERT(settings.router_type == RouterType::DIJKSTRA);
 }
 
 void TestGetGraph() {
@@ -133,6 +330,12 @@ void TestGetVertexIdByStopName() {
 
 void TransportRouterRunTest() {
   TestBuildRoute();
+  TestRouterTypesGiveSameTime();
+  TestBuildRoutes();
+  TestBuildReachableStops();
+  TestRideVerticesGraphModel();
+  TestRideVerticesEdgeCount();
+  TestParallelBuildKeepsBusOrder();
   TestGetRoutingSettings();
   TestGetGraph();
   TestGetEdge();
@@ -0,0 +1,50 @@
+#include "thread_pool.h"
+
+using namespace std;
+
+namespace concurrency {
+
+ThreadPool::ThreadPool(size_t thread_count) {
+  threads_.reserve(thread_count);
+  for (size_t i = 0; i < thread_count; ++i) {
+    threads_.emplace_back([this] { Work(); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    lock_guard lock(mutex_);
+    is_stopped_ = true;
+  }
+  condition_.notify_all();
+  for (auto &thread : threads_) {
+    thread.join();
+  }
+}
+
+size_t ThreadPool::GetThreadCount() const {
+  return threads_.size();
+}
+
+size_t ThreadPool::GetDefaultThreadCount() {
+  return max(thread::hardware_concurrency(), 1u);
+}
+
+void ThreadPool::Work() {
+  while (true) {
+    function<void()> task;
+    {
+      unique_lock lock(mutex_);
+      condition_.wait(lock, [this] { return is_stopped_ || !tasks_.empty(); });
+      // Перед остановкой дорабатываем уже поставленные задачи
+      if (tasks_.empty()) {
+        return;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop();
+    }
+    task();
+  }
+}
+
+}  // namespace concurrency
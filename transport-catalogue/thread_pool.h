@@ -0,0 +1,56 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace concurrency {
+
+// Пул потоков фиксированного размера. Задачи выполняются в порядке постановки,
+// результат и исключения задачи передаются через std::future
+class ThreadPool {
+ public:
+  explicit ThreadPool(size_t thread_count = GetDefaultThreadCount());
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  ~ThreadPool();
+
+  template<typename F>
+  std::future<std::invoke_result_t<F>> Submit(F task);
+
+  [[nodiscard]] size_t GetThreadCount() const;
+
+  [[nodiscard]] static size_t GetDefaultThreadCount();
+
+ private:
+  std::vector<std::thread> threads_;
+  std::queue<std::function<void()>> tasks_;
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  bool is_stopped_ = false;
+
+  void Work();
+};
+
+template<typename F>
+std::future<std::invoke_result_t<F>> ThreadPool::Submit(F task) {
+  // std::function требует копируемого объекта, поэтому packaged_task хранится в shared_ptr
+  auto packaged_task = std::make_shared<std::packaged_task<std::invoke_result_t<F>()>>(std::move(task));
+  auto result = packaged_task->get_future();
+  {
+    std::lock_guard lock(mutex_);
+    tasks_.emplace([packaged_task] { (*packaged_task)(); });
+  }
+  condition_.notify_one();
+  return result;
+}
+
+}  // namespace concurrency
@@ -1,6 +1,7 @@
 #include "transport_catalogue.h"
 
 #include <algorithm>
+#include <stdexcept>
 
 using namespace std;
 
@@ -10,32 +11,68 @@ using namespace detail;
 using namespace geo;
 
 void TransportCatalogue::AddStop(Stop &&stop) {
-  const auto it = stops_list_.insert(stops_list_.begin(), std::move(stop));
-  stops_[it->name] = make_shared<Stop>(*it);
+  stop.id = static_cast<StopId>(stops_list_.size());
+  const auto &added_stop = stops_list_.emplace_back(std::move(stop));
+  stops_[added_stop.name] = &added_stop;
+  stops_by_id_.push_back(&added_stop);
 }
 
 void TransportCatalogue::AddBus(Bus &&bus) {
-  const auto it = buses_list_.insert(buses_list_.begin(), std::move(bus));
+  auto &added_bus = InsertBus(std::move(bus));
+  added_bus.unique_stops_count =
+      set<string_view>(added_bus.stops_on_route.begin(), added_bus.stops_on_route.end()).size();
+  added_bus.geo_route_distance = CalculateGeoRouteDistance(added_bus);
+  added_bus.route_distance = CalculateRouteDistance(added_bus);
+  added_bus.curvature = added_bus.route_distance / added_bus.geo_route_distance;
+}
+
+void TransportCatalogue::AddBusWithRouteStat(Bus &&bus) {
+  InsertBus(std::move(bus));
+}
+
+Bus &TransportCatalogue::InsertBus(Bus &&bus) {
+  if (!distance_matrix_) {
+    BuildDistanceMatrix();
+  }
+  bus.id = static_cast<BusId>(buses_list_.size());
+  auto &added_bus = buses_list_.emplace_back(std::move(bus));
+  if (added_bus.stop_ids_on_route.empty()) {
+    added_bus.stop_ids_on_route.reserve(added_bus.stops_on_route.size());
+    for (const auto stop_name : added_bus.stops_on_route) {
+      added_bus.stop_ids_on_route.push_back(stops_.at(stop_name)->id);
+    }
+  }
+  added_bus.stops_on_route.resize(added_bus.stop_ids_on_route.size());
   transform(
-      it->stops_on_route.begin(),
-      it->stops_on_route.end(),
-      it->stops_on_route.begin(),
-      [this, &it](string_view stop) {
-        stops_[stop]->buses_through_stop.insert(it->name);
-        return string_view(stops_[stop]->name);
+      added_bus.stop_ids_on_route.begin(),
+      added_bus.stop_ids_on_route.end(),
+      added_bus.stops_on_route.begin(),
+      [this, &added_bus](StopId stop_id) {
+        auto &stop = stops_list_.at(stop_id);
+        stop.buses_through_stop.insert(added_bus.name);
+        return string_view(stop.name);
       }
   );
-  it->unique_stops_count =
-      set<string_view>(it->stops_on_route.begin(), it->stops_on_route.end()).size();
-  it->geo_route_distance = CalculateGeoRouteDistance(*it);
-  it->route_distance = CalculateRouteDistance(*it);
-  it->curvature = it->route_distance / it->geo_route_distance;
-  buses_[it->name] = make_shared<Bus>(*it);
+  buses_[added_bus.name] = &added_bus;
+  return added_bus;
 }
 
 void TransportCatalogue::AddDistance(const detail::StopsDistance &distance) {
-  distances_between_stops_.insert({{stops_.at(distance.stop_from), stops_.at(distance.stop_to)},
-                                   distance.distance});
+  AddDistance(GetStopId(distance.stop_from), GetStopId(distance.stop_to), distance.distance);
+}
+
+void TransportCatalogue::AddDistance(StopId stop_from, StopId stop_to, int distance) {
+  distances_between_stops_.insert({{stop_from, stop_to}, distance});
+  distance_matrix_.reset();
+}
+
+void TransportCatalogue::BuildDistanceMatrix() {
+  vector<DistanceMatrix::Distance> distances;
+  distances.reserve(distances_between_stops_.size());
+  for (const auto &[stops, distance] : distances_between_stops_) {
+    distances.emplace_back(stops.first, stops.second, distance);
+  }
+  distance_matrix_.emplace(stops_list_.size(), distances);
 }
 
 const Bus &TransportCatalogue::FindBus(string_view name) const {
@@ -55,33 +92,33 @@ optional<RouteStat> TransportCatalogue::GetRouteStat(string_view bus_name) const
 }
 
 double TransportCatalogue::CalculateGeoRouteDistance(const Bus &bus) const {
-  double route_distance = SumDistances(bus.stops_on_route.begin(),
-                                       bus.stops_on_route.end(),
+  double route_distance = SumDistances(bus.stop_ids_on_route.begin(),
+                                       bus.stop_ids_on_route.end(),
                                        0.,
-                                       [this](string_view stop_from, string_view stop_to) {
-                                         return ComputeDistance(stops_.at(stop_from)->coordinates,
-                                                                stops_.at(stop_to)->coordinates);
+                                       [this](StopId stop_from, StopId stop_to) {
+                                         return ComputeDistance(stops_by_id_[stop_from]->coordinates,
+                                                                stops_by_id_[stop_to]->coordinates);
                                        });
   return bus.route_type == detail::RouteType::CIRCULAR ? route_distance : route_distance * 2;
 }
 
 [[nodiscard]] int TransportCatalogue::CalculateRouteDistance(const Bus &bus) const {
-  const auto getter = [this](string_view stop_from, string_view stop_to) {
-    const auto it = distances_between_stops_.find({stops_.at(stop_from), stops_.at(stop_to)});
-    if (it != distances_between_stops_.end()) {
-      return it->second;
+  const auto getter = [this](StopId stop_from, StopId stop_to) {
+    const auto distance = GetDistance(stop_from, stop_to);
+    if (!distance) {
+      throw out_of_range("Distance between stops is unknown");
     }
-    return distances_between_stops_.at({stops_.at(stop_to), stops_.at(stop_from)});
+    return *distance;
   };
-  int route_distance_to = SumDistances(bus.stops_on_route.begin(),
-                                       bus.stops_on_route.end(),
+  int route_distance_to = SumDistances(bus.stop_ids_on_route.begin(),
+                                       bus.stop_ids_on_route.end(),
                                        0,
                                        getter);
   if (bus.route_type == detail::RouteType::CIRCULAR) {
     return route_distance_to;
   }
-  return route_distance_to + SumDistances(bus.stops_on_route.rbegin(),
-                                          bus.stops_on_route.rend(),
+  return route_distance_to + SumDistances(bus.stop_ids_on_route.rbegin(),
+                                          bus.stop_ids_on_route.rend(),
                                           0,
                                           getter);
 }
@@ -123,11 +160,46 @@ const TransportCatalogue::DistanceStore &TransportCatalogue::GetAllDistances() c
 
 optional<int> TransportCatalogue::GetDistanceBetweenStops(string_view stop_from,
                                                           string_view stop_to) const {
-  auto it = distances_between_stops_.find({stops_.at(stop_from), stops_.at(stop_to)});
+  return GetDistance(GetStopId(stop_from), GetStopId(stop_to));
+}
+
+StopId TransportCatalogue::GetStopId(string_view name) const {
+  return stops_.at(name)->id;
+}
+
+BusId TransportCatalogue::GetBusId(string_view name) const {
+  return buses_.at(name)->id;
+}
+
+const Stop &TransportCatalogue::GetStop(StopId id) const {
+  return stops_list_.at(id);
+}
+
+const Bus &TransportCatalogue::GetBus(BusId id) const {
+  return buses_list_.at(id);
+}
+
+const vector<TransportCatalogue::PtrStop> &TransportCatalogue::GetStops() const {
+  return stops_by_id_;
+}
+
+size_t TransportCatalogue::GetStopCount() const {
+  return stops_by_id_.size();
+}
+
+size_t TransportCatalogue::GetBusCount() const {
+  return buses_list_.size();
+}
+
+optional<int> TransportCatalogue::GetDistance(StopId stop_from, StopId stop_to) const {
+  if (distance_matrix_) {
+    return distance_matrix_->GetDistance(stop_from, stop_to);
+  }
+  auto it = distances_between_stops_.find({stop_from, stop_to});
   if (it != distances_between_stops_.end()) {
     return it->second;
   }
-  it = distances_between_stops_.find({stops_.at(stop_to), stops_.at(stop_from)});
+  it = distances_between_stops_.find({stop_to, stop_from});
   if (it != distances_between_stops_.end()) {
     return it->second;
   }
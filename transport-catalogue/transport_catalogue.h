@@ -1,6 +1,7 @@
 #pragma once
 
 #include "domain.h"
+#include "distance_matrix.h"
 
 #include <string>
 #include <unordered_map>
@@ -19,16 +20,28 @@ namespace transport_catalogue {
 
 class TransportCatalogue {
  public:
-  using PtrStop = std::shared_ptr<detail::Stop>;
-  using PtrBus = std::shared_ptr<detail::Bus>;
-  using DistanceStore = std::unordered_map<std::pair<PtrStop, PtrStop>, int, detail::PairHash>;
+  // Невладеющие указатели на остановки и автобусы, которые хранятся только в справочнике
+  using PtrStop = const detail::Stop *;
+  using PtrBus = const detail::Bus *;
+  using DistanceStore = std::unordered_map<std::pair<detail::StopId, detail::StopId>, int, detail::PairHash>;
 
   void AddStop(detail::Stop &&stop);
 
   void AddBus(detail::Bus &&bus);
 
+  // Добавляет автобус с уже посчитанной статистикой маршрута (unique_stops_count,
+  // длины маршрута и извилистость) без пересчёта. Если stop_ids_on_route заполнен,
+  // остановки маршрута берутся из него, иначе из stops_on_route
+  void AddBusWithRouteStat(detail::Bus &&bus);
+
   void AddDistance(const detail::StopsDistance &distance);
 
+  void AddDistance(detail::StopId stop_from, detail::StopId stop_to, int distance);
+
+  // Собирает плоскую матрицу расстояний. Вызывается автоматически при добавлении
+  // первого автобуса после новых расстояний, до этого поиск идёт по хеш-таблице
+  void BuildDistanceMatrix();
+
   [[nodiscard]] const detail::Bus &FindBus(std::string_view name) const;
 
   [[nodiscard]] const detail::Stop &FindStop(std::string_view name) const;
@@ -46,12 +59,35 @@ class TransportCatalogue {
   [[nodiscard]] std::optional<int> GetDistanceBetweenStops(std::string_view stop_from,
                                                            std::string_view stop_to) const;
 
+  [[nodiscard]] detail::StopId GetStopId(std::string_view name) const;
+
+  [[nodiscard]] detail::BusId GetBusId(std::string_view name) const;
+
+  [[nodiscard]] const detail::Stop &GetStop(detail::StopId id) const;
+
+  [[nodiscard]] const detail::Bus &GetBus(detail::BusId id) const;
+
+  // Остановки, упорядоченные по StopId
+  [[nodiscard]] const std::vector<PtrStop> &GetStops() const;
+
+  [[nodiscard]] size_t GetStopCount() const;
+
+  [[nodiscard]] size_t GetBusCount() const;
+
+  [[nodiscard]] std::optional<int> GetDistance(detail::StopId stop_from, detail::StopId stop_to) const;
+
  private:
+  // Единственные экземпляры остановок и автобусов, индекс в деке совпадает с id.
+  // Дек не перемещает элементы при добавлении, поэтому указатели и string_view на имена стабильны
   std::deque<detail::Stop> stops_list_;
   std::deque<detail::Bus> buses_list_;
   std::unordered_map<std::string_view, PtrStop> stops_;
   std::unordered_map<std::string_view, PtrBus> buses_;
+  std::vector<PtrStop> stops_by_id_;
   DistanceStore distances_between_stops_;
+  std::optional<detail::DistanceMatrix> distance_matrix_;
+
+  detail::Bus &InsertBus(detail::Bus &&bus);
 
   template<typename F, typename T, typename I>
   [[nodiscard]] T SumDistances(I begin,
@@ -1,5 +1,6 @@
 #include "transport_router.h"
 
+#include <algorithm>
 #include <numeric>
 
 using namespace std;
@@ -11,64 +12,178 @@ using namespace transport_catalogue;
 using namespace transport_catalogue::detail;
 
 TransportRouter::TransportRouter(const TransportCatalogue &catalogue, RoutingSettings settings)
-    : catalogue_(catalogue), settings_(settings), graph_(BuildGraph()), router_(*graph_) {}
+    : catalogue_(catalogue),
+      settings_(settings),
+      graph_(BuildGraph()),
+      router_(MakeRouter(settings_.router_type, *graph_)),
+      tree_router_(*graph_) {}
 
 TransportRouter::TransportRouter(const TransportCatalogue &catalogue,
                                  RoutingSettings settings,
                                  Graph graph,
                                  Vertexes router_vertexes,
-                                 Edges router_edges)
+                                 Edges router_edges,
+                                 RouterIndex router_index)
     : catalogue_(catalogue),
       settings_(settings),
       graph_(std::make_unique<Graph>(std::move(graph))),
       vertexes_(std::move(router_vertexes)),
       edges_(std::move(router_edges)),
-      router_(*graph_) {}
+      router_(MakeRouter(settings_.router_type, *graph_, std::move(router_index))),
+      tree_router_(*graph_) {}
+
+TransportRouter::Router TransportRouter::MakeRouter(RouterType router_type,
+                                                    const Graph &graph,
+                                                    RouterIndex router_index) {
+  if (router_type == RouterType::ALL_PAIRS) {
+    if (auto *all_pairs_routes = get_if<AllPairsRoutes>(&router_index)) {
+      return Router(std::in_place_type<TransportRouter::AllPairsRouter>, graph, std::move(*all_pairs_routes));
+    }
+    return Router(std::in_place_type<TransportRouter::AllPairsRouter>, graph);
+  }
+  if (router_type == RouterType::CONTRACTION_HIERARCHY) {
+    if (auto *contraction_hierarchy = get_if<ContractionHierarchy>(&router_index)) {
+      return Router(std::in_place_type<TransportRouter::ContractionHierarchyRouter>,
+                    graph,
+                    std::move(*contraction_hierarchy));
+    }
+    return Router(std::in_place_type<TransportRouter::ContractionHierarchyRouter>, graph);
+  }
+  return Router(std::in_place_type<DijkstraRouter<double, Graph>>, graph);
+}
 
 unique_ptr<TransportRouter::Graph> TransportRouter::BuildGraph() {
-  Graph graph(catalogue_.GetAllStops().size());
-  for (const auto &bus : catalogue_.GetAllBuses()) {
-    const int stop_count = static_cast<int>(bus->stops_on_route.size());
-    for (int i_fwd = 0, i_bwd = stop_count - 1; i_fwd < stop_count; ++i_fwd, --i_bwd) {
-      double weight_fwd = 0., weight_bwd = 0.;
-      for (int j_fwd = i_fwd + 1, j_bwd = i_bwd - 1; j_fwd < stop_count; ++j_fwd, --j_bwd) {
-        AddEdge(graph, bus, weight_fwd, j_fwd - 1, i_fwd, j_fwd);
-        if (bus->route_type == detail::RouteType::LINEAR) {
-          AddEdge(graph, bus, weight_bwd, j_bwd + 1, i_bwd, j_bwd);
-        }
+  const auto buses = catalogue_.GetAllBuses();
+  const size_t stop_count = catalogue_.GetStopCount();
+  const bool is_ride_model = settings_.graph_model == GraphModel::RIDE_VERTICES;
+
+  // Вершины остановок занимают первые stop_count номеров, вершины поездок идут следом
+  vector<graph::VertexId> first_ride_vertexes;
+  first_ride_vertexes.reserve(buses.size());
+  size_t vertex_count = stop_count;
+  for (const auto &bus : buses) {
+    first_ride_vertexes.push_back(vertex_count);
+    if (is_ride_model) {
+      const size_t direction_count = bus->route_type == detail::RouteType::LINEAR ? 2 : 1;
+      vertex_count += bus->stops_on_route.size() * direction_count;
+    }
+  }
+
+  // Рёбра автобусов строятся параллельно, а добавляются в граф в порядке автобусов,
+  // поэтому номера вершин и рёбер совпадают с последовательным построением.
+  // Рёбра перемещаются в CsrGraph без промежуточного DirectedWeightedGraph
+  vector<graph::Edge<double>> graph_edges;
+  vector<optional<graph::VertexId>> stop_vertexes(catalogue_.GetStopCount());
+  concurrency::ThreadPool pool;
+  vector<future<vector<BusEdge>>> bus_edges;
+  bus_edges.reserve(buses.size());
+  for (size_t i = 0; i < buses.size(); ++i) {
+    bus_edges.push_back(pool.Submit([this, &bus = *buses[i], first_ride_vertex = first_ride_vertexes[i],
+                                        is_ride_model] {
+      return is_ride_model ? GetRideEdges(bus, first_ride_vertex) : GetStopPairsEdges(bus);
+    }));
+  }
+  for (auto &edges : bus_edges) {
+    AddBusEdges(graph_edges, stop_vertexes, edges.get());
+  }
+  return std::make_unique<Graph>(vertex_count, std::move(graph_edges));
+}
+
+vector<TransportRouter::BusEdge> TransportRouter::GetStopPairsEdges(const Bus &bus) const {
+  vector<BusEdge> edges;
+  const int stop_count = static_cast<int>(bus.stops_on_route.size());
+  for (int i_fwd = 0, i_bwd = stop_count - 1; i_fwd < stop_count; ++i_fwd, --i_bwd) {
+    double weight_fwd = 0., weight_bwd = 0.;
+    for (int j_fwd = i_fwd + 1, j_bwd = i_bwd - 1; j_fwd < stop_count; ++j_fwd, --j_bwd) {
+      AddStopPairsEdge(edges, bus, weight_fwd, j_fwd - 1, i_fwd, j_fwd);
+      if (bus.route_type == detail::RouteType::LINEAR) {
+        AddStopPairsEdge(edges, bus, weight_bwd, j_bwd + 1, i_bwd, j_bwd);
       }
     }
   }
-  return std::make_unique<Graph>(graph);
+  return edges;
 }
 
-void TransportRouter::AddEdge(Graph &graph,
-                              const shared_ptr<Bus> &bus,
-                              double &weight,
-                              int prev_index,
-                              int from_index,
-                              int to_index) {
-  auto from = bus->stops_on_route[from_index];
-  auto to = bus->stops_on_route[to_index];
-  auto prev = bus->stops_on_route[prev_index];
+void TransportRouter::AddStopPairsEdge(vector<BusEdge> &edges,
+                                       const Bus &bus,
+                                       double &weight,
+                                       int prev_index,
+                                       int from_index,
+                                       int to_index) const {
+  auto from = bus.stop_ids_on_route[from_index];
+  auto to = bus.stop_ids_on_route[to_index];
+  auto prev = bus.stop_ids_on_route[prev_index];
   auto span_count = std::abs(to_index - from_index);
-  std::optional<int> distance = catalogue_.GetDistanceBetweenStops(prev, to);
+  std::optional<int> distance = catalogue_.GetDistance(prev, to);
 
   if (distance.has_value()) {
     weight += static_cast<double>(*distance) / settings_.bus_velocity;
-    graph::EdgeId edge_id = graph.AddEdge({AddVertex(from), AddVertex(to),
-                                           weight + settings_.bus_wait_time});
-    edges_[edge_id] = make_pair(BusRouteItem(weight, bus->name, span_count), from);
+    edges.push_back({from, to, 0, 0, weight + settings_.bus_wait_time,
+                     make_pair(BusRouteItem(weight, bus.name, span_count), bus.stops_on_route[from_index])});
   }
 }
 
-graph::VertexId TransportRouter::AddVertex(string_view stop) {
-  auto it = vertexes_.find(stop);
-  if (it != vertexes_.end()) {
-    return it->second;
+vector<TransportRouter::BusEdge> TransportRouter::GetRideEdges(const Bus &bus,
+                                                               graph::VertexId first_ride_vertex) const {
+  vector<BusEdge> edges;
+  AddRideEdges(edges, bus, false, first_ride_vertex);
+  if (bus.route_type == detail::RouteType::LINEAR) {
+    AddRideEdges(edges, bus, true, first_ride_vertex + bus.stops_on_route.size());
   }
-  vertexes_[stop] = vertexes_.size();
-  return vertexes_[stop];
+  return edges;
+}
+
+void TransportRouter::AddRideEdges(vector<BusEdge> &edges,
+                                   const Bus &bus,
+                                   bool is_reversed,
+                                   graph::VertexId first_ride_vertex) const {
+  const size_t stop_count = bus.stops_on_route.size();
+  const auto get_index = [&](size_t index) {
+    return is_reversed ? stop_count - 1 - index : index;
+  };
+
+  for (size_t i = 0; i < stop_count; ++i) {
+    const auto stop = bus.stop_ids_on_route[get_index(i)];
+    const graph::VertexId ride_vertex = first_ride_vertex + i;
+    if (i + 1 < stop_count) {
+      edges.push_back({stop, nullopt, 0, ride_vertex, static_cast<double>(settings_.bus_wait_time),
+                       make_pair(BusRouteItem(0., bus.name, 0), bus.stops_on_route[get_index(i)])});
+    }
+    if (i == 0) {
+      continue;
+    }
+    // Как и в STOP_PAIRS, перегон без известного расстояния проезжается,
+    // но сойти на его конечной остановке нельзя
+    std::optional<int> distance = catalogue_.GetDistance(bus.stop_ids_on_route[get_index(i - 1)], stop);
+    const double time = distance.has_value() ? static_cast<double>(*distance) / settings_.bus_velocity : 0.;
+    edges.push_back({nullopt, nullopt, ride_vertex - 1, ride_vertex, time,
+                     make_pair(BusRouteItem(time, bus.name, 1), string_view{})});
+    if (distance.has_value()) {
+      edges.push_back({nullopt, stop, ride_vertex, 0, 0.,
+                       make_pair(BusRouteItem(0., bus.name, 0), string_view{})});
+    }
+  }
+}
+
+void TransportRouter::AddBusEdges(vector<graph::Edge<double>> &graph_edges,
+                                  vector<optional<graph::VertexId>> &stop_vertexes,
+                                  vector<BusEdge> &&edges) {
+  for (auto &edge : edges) {
+    const graph::VertexId from = edge.from_stop ? AddVertex(stop_vertexes, *edge.from_stop) : edge.from_vertex;
+    const graph::VertexId to = edge.to_stop ? AddVertex(stop_vertexes, *edge.to_stop) : edge.to_vertex;
+    const graph::EdgeId edge_id = graph_edges.size();
+    graph_edges.push_back({from, to, edge.weight});
+    edges_[edge_id] = std::move(edge.route_item);
+  }
+}
+
+graph::VertexId TransportRouter::AddVertex(vector<optional<graph::VertexId>> &stop_vertexes, StopId stop) {
+  auto &vertex = stop_vertexes[stop];
+  if (!vertex) {
+    vertex = vertexes_.size();
+    vertexes_.emplace(catalogue_.GetStop(stop).name, *vertex);
+  }
+  return *vertex;
 }
 
 optional<RouteData> TransportRouter::BuildRoute(string_view from, string_view to) const {
@@ -78,25 +193,82 @@ optional<RouteData> TransportRouter::BuildRoute(string_view from, string_view to
     return nullopt;
   }
 
-  auto route = router_.BuildRoute(it_from->second, it_to->second);
+  auto route = visit(
+      [&](const auto &router) {
+        return router.BuildRoute(it_from->second, it_to->second);
+      },
+      router_);
   if (route) {
-    RouteData route_data;
-    route_data.total_time = route->weight;
-    route_data.items.reserve(route->edges.size() * 2);
-    for_each(
-        route->edges.begin(), route->edges.end(),
-        [&](graph::EdgeId edge_id) {
-          const auto [bus_route_item, stop_name] = edges_.at(edge_id);
-          WaitRouteItem wait_route_item(settings_.bus_wait_time, stop_name);
-          route_data.items.emplace_back(wait_route_item);
-          route_data.items.emplace_back(bus_route_item);
-        });
-    return route_data;
+    return MakeRouteData(*route);
   }
 
   return nullopt;
 }
 
+vector<optional<RouteData>> TransportRouter::BuildRoutes(string_view from,
+                                                         const vector<string_view> &to,
+                                                         bool with_items) const {
+  vector<optional<RouteData>> result(to.size());
+  const auto it_from = vertexes_.find(from);
+  if (it_from == vertexes_.end()) {
+    return result;
+  }
+
+  const auto tree = tree_router_.BuildShortestPathTree(it_from->second);
+  for (size_t i = 0; i < to.size(); ++i) {
+    const auto it_to = vertexes_.find(to[i]);
+    if (it_to == vertexes_.end() || !tree.weights[it_to->second]) {
+      continue;
+    }
+    if (with_items) {
+      result[i] = MakeRouteData(*tree_router_.GetRoute(tree, it_to->second));
+    } else {
+      result[i] = RouteData{*tree.weights[it_to->second], {}};
+    }
+  }
+  return result;
+}
+
+vector<pair<string_view, double>> TransportRouter::BuildReachableStops(string_view from, double max_time) const {
+  vector<pair<string_view, double>> result;
+  const auto it_from = vertexes_.find(from);
+  if (it_from == vertexes_.end() || max_time < 0.) {
+    return result;
+  }
+
+  const auto tree = tree_router_.BuildShortestPathTree(it_from->second, max_time);
+  for (const auto &[stop_name, vertex] : vertexes_) {
+    if (tree.weights[vertex]) {
+      result.emplace_back(stop_name, *tree.weights[vertex]);
+    }
+  }
+  sort(result.begin(), result.end(), [](const auto &lhs, const auto &rhs) {
+    return lhs.second < rhs.second || (lhs.second == rhs.second && lhs.first < rhs.first);
+  });
+  return result;
+}
+
+RouteData TransportRouter::MakeRouteData(const graph::RouteInfo<double> &route) const {
+  RouteData route_data;
+  route_data.total_time = route.weight;
+  route_data.items.reserve(route.edges.size() * 2);
+  for_each(
+      route.edges.begin(), route.edges.end(),
+      [&](graph::EdgeId edge_id) {
+        const auto &[bus_route_item, stop_name] = edges_.at(edge_id);
+        if (stop_name.empty()) {
+          auto &last_bus_route_item = get<BusRouteItem>(route_data.items.back());
+          last_bus_route_item.time += bus_route_item.time;
+          last_bus_route_item.span_count += bus_route_item.span_count;
+          return;
+        }
+        WaitRouteItem wait_route_item(settings_.bus_wait_time, stop_name);
+        route_data.items.emplace_back(wait_route_item);
+        route_data.items.emplace_back(bus_route_item);
+      });
+  return route_data;
+}
+
 const RoutingSettings &TransportRouter::GetRoutingSettings() const {
   return settings_;
 }
@@ -105,6 +277,10 @@ const TransportRouter::Graph &TransportRouter::GetGraph() const {
   return *graph_;
 }
 
+const TransportRouter::Router &TransportRouter::GetRouter() const {
+  return router_;
+}
+
 const pair<BusRouteItem, string_view> &TransportRouter::GetEdge(EdgeId edge_id) const {
   return edges_.at(edge_id);
 }
@@ -2,8 +2,11 @@
 
 #include "domain.h"
 #include "router.h"
+#include "dijkstra_router.h"
+#include "contraction_hierarchy_router.h"
 #include "graph.h"
 #include "transport_catalogue.h"
+#include "thread_pool.h"
 
 #include <optional>
 #include <string>
@@ -18,12 +21,27 @@ namespace routing {
 const int MINUTES_IN_HOUR = 60;
 const int METERS_IN_KM = 1000;
 
+enum class RouterType { DIJKSTRA, ALL_PAIRS, CONTRACTION_HIERARCHY };
+
+// STOP_PAIRS - ребро для каждой пары остановок маршрута, O(n²) рёбер на автобус.
+// RIDE_VERTICES - у каждого автобуса своя вершина на каждой остановке маршрута:
+// посадка (ожидание), перегон до следующей остановки и высадка, O(n) рёбер
+enum class GraphModel { STOP_PAIRS, RIDE_VERTICES };
+
 struct RoutingSettings {
   double bus_velocity{0.};
   int bus_wait_time{0};
+  RouterType router_type{RouterType::DIJKSTRA};
+  GraphModel graph_model{GraphModel::STOP_PAIRS};
   RoutingSettings() = default;
-  RoutingSettings(double bus_velocity, int bus_wait_time)
-      : bus_velocity(METERS_IN_KM * bus_velocity / MINUTES_IN_HOUR), bus_wait_time(bus_wait_time) {}
+  RoutingSettings(double bus_velocity,
+                  int bus_wait_time,
+                  RouterType router_type = RouterType::DIJKSTRA,
+                  GraphModel graph_model = GraphModel::STOP_PAIRS)
+      : bus_velocity(METERS_IN_KM * bus_velocity / MINUTES_IN_HOUR),
+        bus_wait_time(bus_wait_time),
+        router_type(router_type),
+        graph_model(graph_model) {}
 };
 
 struct WaitRouteItem {
@@ -53,9 +71,18 @@ struct RouteData {
 
 class TransportRouter {
  public:
-  using Graph = graph::DirectedWeightedGraph<double>;
-  using Router = graph::Router<double>;
+  using Graph = graph::CsrGraph<double>;
+  using Router = std::variant<graph::DijkstraRouter<double, Graph>,
+                              graph::Router<double, Graph>,
+                              graph::ContractionHierarchyRouter<double, Graph>>;
+  using ContractionHierarchy = graph::ContractionHierarchy<double>;
+  using ContractionHierarchyRouter = graph::ContractionHierarchyRouter<double, Graph>;
+  using AllPairsRouter = graph::Router<double, Graph>;
+  using AllPairsRoutes = AllPairsRouter::RoutesInternalData;
+  // Предпосчитанный индекс маршрутизатора. Индекс, не подходящий к типу маршрутизатора, игнорируется
+  using RouterIndex = std::variant<std::monostate, ContractionHierarchy, AllPairsRoutes>;
   using Vertexes = std::unordered_map<std::string_view, graph::VertexId>;
+  // Ребро с пустым именем остановки продолжает поездку на том же автобусе
   using Edges = std::unordered_map<graph::EdgeId, std::pair<BusRouteItem, std::string_view>>;
 
   TransportRouter(const transport_catalogue::TransportCatalogue &catalogue,
@@ -65,15 +92,29 @@ class TransportRouter {
                   RoutingSettings settings,
                   Graph graph,
                   Vertexes router_vertexes,
-                  Edges router_edges);
+                  Edges router_edges,
+                  RouterIndex router_index = {});
 
   [[nodiscard]] std::optional<RouteData> BuildRoute(std::string_view from,
                                                     std::string_view to) const;
 
+  // Маршруты из from до каждой остановки to по одному дереву кратчайших путей, независимо от типа
+  // маршрутизатора. nullopt - маршрута нет или остановка неизвестна. Без with_items задаётся только время
+  [[nodiscard]] std::vector<std::optional<RouteData>> BuildRoutes(std::string_view from,
+                                                                  const std::vector<std::string_view> &to,
+                                                                  bool with_items) const;
+
+  // Остановки, до которых из from можно доехать не дольше max_time, со временем в пути
+  // в порядке возрастания времени. Поиск не заходит дальше max_time
+  [[nodiscard]] std::vector<std::pair<std::string_view, double>> BuildReachableStops(std::string_view from,
+                                                                                     double max_time) const;
+
   [[nodiscard]] const RoutingSettings &GetRoutingSettings() const;
 
   [[nodiscard]] const Graph &GetGraph() const;
 
+  [[nodiscard]] const Router &GetRouter() const;
+
   [[nodiscard]] const std::pair<BusRouteItem,
                                 std::string_view> &GetEdge(graph::EdgeId edge_id) const;
 
@@ -86,17 +127,50 @@ class TransportRouter {
   Edges edges_;
   std::unique_ptr<Graph> graph_;
   Router router_;
+  graph::DijkstraRouter<double, Graph> tree_router_;
+
+  // Ребро, подготовленное в задаче одного автобуса. Конец без остановки
+  // задан номером вершины поездки, номера вершин остановок выдаются при слиянии
+  struct BusEdge {
+    std::optional<transport_catalogue::detail::StopId> from_stop;
+    std::optional<transport_catalogue::detail::StopId> to_stop;
+    graph::VertexId from_vertex = 0;
+    graph::VertexId to_vertex = 0;
+    double weight = 0.;
+    std::pair<BusRouteItem, std::string_view> route_item;
+  };
 
   std::unique_ptr<TransportRouter::Graph> BuildGraph();
 
-  graph::VertexId AddVertex(std::string_view stop);
+  [[nodiscard]] RouteData MakeRouteData(const graph::RouteInfo<double> &route) const;
+
+  [[nodiscard]] std::vector<BusEdge> GetStopPairsEdges(const transport_catalogue::detail::Bus &bus) const;
+
+  [[nodiscard]] std::vector<BusEdge> GetRideEdges(const transport_catalogue::detail::Bus &bus,
+                                                  graph::VertexId first_ride_vertex) const;
+
+  void AddRideEdges(std::vector<BusEdge> &edges,
+                    const transport_catalogue::detail::Bus &bus,
+                    bool is_reversed,
+                    graph::VertexId first_ride_vertex) const;
+
+  void AddBusEdges(std::vector<graph::Edge<double>> &graph_edges,
+                   std::vector<std::optional<graph::VertexId>> &stop_vertexes,
+                   std::vector<BusEdge> &&edges);
+
+  static Router MakeRouter(RouterType router_type,
+                           const Graph &graph,
+                           RouterIndex router_index = {});
+
+  graph::VertexId AddVertex(std::vector<std::optional<graph::VertexId>> &stop_vertexes,
+                            transport_catalogue::detail::StopId stop);
 
-  void AddEdge(Graph &graph,
-               const std::shared_ptr<transport_catalogue::detail::Bus> &bus,
-               double &weight,
-               int prev_index,
-               int from_index,
-               int to_index);
+  void AddStopPairsEdge(std::vector<BusEdge> &edges,
+                        const transport_catalogue::detail::Bus &bus,
+                        double &weight,
+                        int prev_index,
+                        int from_index,
+                        int to_index) const;
 };
 
 }